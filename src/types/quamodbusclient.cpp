@@ -1,10 +1,18 @@
 #include "quamodbusclient.h"
 
 #include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QtMath>
 
 #include <QUaModbusDataBlock>
 #include <QUaModbusClientList>
 
+int QUaModbusClient::m_connectingCount = 0;
+int QUaModbusClient::m_maxConcurrentConnects = 8;
+int QUaModbusClient::m_connectTimeout = 10000;
+quint32 QUaModbusClient::m_minReconnectDelay = 100;
+QList<QPointer<QUaModbusClient>> QUaModbusClient::m_connectQueue;
+
 QUaModbusClient::QUaModbusClient(QUaServer *server)
 #ifndef QUA_ACCESS_CONTROL
 	: QUaBaseObject(server)
@@ -14,11 +22,25 @@ QUaModbusClient::QUaModbusClient(QUaServer *server)
 	, m_mutex(QMutex::Recursive)
 {
 	m_disconnectRequested = false;
+	m_reconnectAttempts = 0;
+	m_holdsConnectSlot = false;
 	m_type = nullptr;
 	m_serverAddress = nullptr;
 	m_keepConnecting = nullptr;
+	m_timeout = nullptr;
+	m_retries = nullptr;
+	m_adaptiveTimeout = nullptr;
+	m_reconnectDelay = nullptr;
+	m_maxReconnectDelay = nullptr;
+	m_breakerThreshold = nullptr;
+	m_breakerProbeInterval = nullptr;
+	m_minSamplingTime = nullptr;
+	m_enabled = nullptr;
 	m_state = nullptr;
 	m_lastError = nullptr;
+	m_writeQueueDelay = nullptr;
+	m_effectiveTimeout = nullptr;
+	m_breakerState = nullptr;
 	m_dataBlocks = nullptr;
 	if (QMetaType::type("QModbusError") == QMetaType::UnknownType)
 	{
@@ -28,35 +50,133 @@ QUaModbusClient::QUaModbusClient(QUaServer *server)
 	{
 		qRegisterMetaType<QModbusState>("QModbusState");
 	}
+	if (QMetaType::type("QUaModbusScheduler::BreakerState") == QMetaType::UnknownType)
+	{
+		qRegisterMetaType<QUaModbusScheduler::BreakerState>("QUaModbusScheduler::BreakerState");
+	}
+	// instantiate scheduler in thread so it runs on the thread
+	m_workerThread.execInThread([this]() {
+		m_scheduler.reset(new QUaModbusScheduler(nullptr), [](QObject* scheduler) {
+			scheduler->deleteLater();
+		});
+		QObject::connect(m_scheduler.data(), &QUaModbusScheduler::writeDispatched, this, &QUaModbusClient::on_writeDispatched, Qt::QueuedConnection);
+		// apply adapted timeout in thread, update ua variable in ua server thread
+		QObject::connect(m_scheduler.data(), &QUaModbusScheduler::timeoutChanged, m_scheduler.data(), [this](const int &timeout) {
+			if (m_modbusClient)
+			{
+				m_modbusClient->setTimeout(timeout);
+			}
+		});
+		QObject::connect(m_scheduler.data(), &QUaModbusScheduler::timeoutChanged, this, &QUaModbusClient::on_timeoutAdapted, Qt::QueuedConnection);
+		QObject::connect(m_scheduler.data(), &QUaModbusScheduler::breakerStateChanged, this, &QUaModbusClient::on_breakerStateChanged, Qt::QueuedConnection);
+	});
 	// set defaults
 	state         ()->setDataTypeEnum(QMetaEnum::fromType<QModbusState>());
 	state         ()->setValue(QModbusState::UnconnectedState);
 	lastError     ()->setDataTypeEnum(QMetaEnum::fromType<QModbusError>());
 	lastError     ()->setValue(QModbusError::NoError);
+	writeQueueDelay()->setDataType(QMetaType::Double);
+	writeQueueDelay()->setValue(0.0);
 	serverAddress ()->setDataType(QMetaType::UChar);
 	serverAddress ()->setValue(1);
 	keepConnecting()->setValue(false);
+	timeout       ()->setDataType(QMetaType::Int);
+	timeout       ()->setValue(1000);
+	retries       ()->setDataType(QMetaType::Int);
+	retries       ()->setValue(3);
+	adaptiveTimeout()->setValue(false);
+	reconnectDelay()->setDataType(QMetaType::UInt);
+	reconnectDelay()->setValue(1000);
+	maxReconnectDelay()->setDataType(QMetaType::UInt);
+	maxReconnectDelay()->setValue(60000);
+	breakerThreshold()->setDataType(QMetaType::UInt);
+	breakerThreshold()->setValue(3);
+	breakerProbeInterval()->setDataType(QMetaType::UInt);
+	breakerProbeInterval()->setValue(5000);
+	minSamplingTime()->setDataType(QMetaType::UInt);
+	minSamplingTime()->setValue(50);
+	enabled()->setValue(true);
+	breakerState()->setDataTypeEnum(QMetaEnum::fromType<QUaModbusScheduler::BreakerState>());
+	breakerState()->setValue(QUaModbusScheduler::Closed);
+	effectiveTimeout()->setDataType(QMetaType::Int);
+	effectiveTimeout()->setValue(1000);
 	// set initial conditions
 	serverAddress ()->setWriteAccess(true);
 	keepConnecting()->setWriteAccess(true);
+	timeout       ()->setWriteAccess(true);
+	retries       ()->setWriteAccess(true);
+	adaptiveTimeout()->setWriteAccess(true);
+	reconnectDelay()->setWriteAccess(true);
+	maxReconnectDelay()->setWriteAccess(true);
+	breakerThreshold()->setWriteAccess(true);
+	breakerProbeInterval()->setWriteAccess(true);
+	minSamplingTime()->setWriteAccess(true);
+	enabled()->setWriteAccess(true);
 	// set descriptions
 	/*
 	type          ()->setDescription(tr("Modbus client communication type (TCP or RTU Serial)."));
 	serverAddress ()->setDescription(tr("Modbus server Device Id or Modbus address."));
 	keepConnecting()->setDescription(tr("Whether the client should try to keep connecting after connection failure"));
+	timeout       ()->setDescription(tr("Time in ms to wait for a reply (upper bound if AdaptiveTimeout is set)."));
+	retries       ()->setDescription(tr("Number of times a request is resent before reporting a timeout."));
+	adaptiveTimeout()->setDescription(tr("Derive the timeout from the measured round trip time and its variance."));
+	reconnectDelay()->setDescription(tr("Time in ms to wait before reconnecting, doubles after each failed attempt (minimum 100 ms)."));
+	maxReconnectDelay()->setDescription(tr("Maximum time in ms to wait before reconnecting."));
+	breakerThreshold()->setDescription(tr("Consecutive failures after which a server is no longer polled, only probed (0 disables)."));
+	breakerProbeInterval()->setDescription(tr("Time in ms between probe reads to a server that is not polled."));
+	minSamplingTime()->setDescription(tr("Lowest sampling time in ms allowed to the blocks of this client. Blocks faster than 50 ms are polled with precise timers."));
+	enabled()->setDescription(tr("A disabled client does not connect and its blocks are not polled, but its configuration is kept."));
+	breakerState()->setDescription(tr("Circuit breaker state of the Modbus server of the client."));
+	effectiveTimeout()->setDescription(tr("Time in ms the client currently waits for a reply."));
 	state         ()->setDescription(tr("Modbus connection state."));
 	lastError     ()->setDescription(tr("Last error occured at connection level."));
+	writeQueueDelay()->setDescription(tr("Time in ms the last write waited in queue before being sent."));
 	dataBlocks    ()->setDescription(tr("List of Modbus data blocks updated through polling."));
 	*/
 	// handle changes
 	QObject::connect(serverAddress() , &QUaBaseVariable::valueChanged, this, &QUaModbusClient::on_serverAddressChanged , Qt::QueuedConnection);
 	QObject::connect(keepConnecting(), &QUaBaseVariable::valueChanged, this, &QUaModbusClient::on_keepConnectingChanged, Qt::QueuedConnection);
+	QObject::connect(timeout()       , &QUaBaseVariable::valueChanged, this, &QUaModbusClient::on_timeoutChanged       , Qt::QueuedConnection);
+	QObject::connect(retries()       , &QUaBaseVariable::valueChanged, this, &QUaModbusClient::on_retriesChanged       , Qt::QueuedConnection);
+	QObject::connect(adaptiveTimeout(), &QUaBaseVariable::valueChanged, this, &QUaModbusClient::on_adaptiveTimeoutChanged, Qt::QueuedConnection);
+	QObject::connect(reconnectDelay(), &QUaBaseVariable::valueChanged, this, &QUaModbusClient::on_reconnectDelayChanged, Qt::QueuedConnection);
+	QObject::connect(maxReconnectDelay(), &QUaBaseVariable::valueChanged, this, &QUaModbusClient::on_maxReconnectDelayChanged, Qt::QueuedConnection);
+	QObject::connect(breakerThreshold(), &QUaBaseVariable::valueChanged, this, &QUaModbusClient::on_breakerThresholdChanged, Qt::QueuedConnection);
+	QObject::connect(breakerProbeInterval(), &QUaBaseVariable::valueChanged, this, &QUaModbusClient::on_breakerProbeIntervalChanged, Qt::QueuedConnection);
+	QObject::connect(minSamplingTime(), &QUaBaseVariable::valueChanged, this, &QUaModbusClient::on_minSamplingTimeChanged, Qt::QueuedConnection);
+	QObject::connect(enabled(), &QUaBaseVariable::valueChanged, this, &QUaModbusClient::on_enabledChanged, Qt::QueuedConnection);
+	// reconnect when backoff expires
+	m_reconnectTimer.setSingleShot(true);
+	QObject::connect(&m_reconnectTimer, &QTimer::timeout, this, [this]() {
+		if (!this->getKeepConnecting())
+		{
+			return;
+		}
+		this->connectDevice();
+	});
+	// abort connection attempts that take too long
+	m_connectTimer.setSingleShot(true);
+	QObject::connect(&m_connectTimer, &QTimer::timeout, this, [this]() {
+		if (this->getState() != QModbusState::ConnectingState)
+		{
+			return;
+		}
+		// let others connect, the disconnection schedules the next attempt
+		this->releaseConnectSlot();
+		this->setLastError(QModbusError::TimeoutError);
+		m_workerThread.execInThread([this]() {
+			m_modbusClient->disconnectDevice();
+		});
+	});
 }
 
 QUaModbusClient::~QUaModbusClient()
 {
 	emit this->aboutToDestroy();
 	emit m_dataBlocks->aboutToClear();
+	// let others connect
+	m_connectQueue.removeAll(this);
+	this->releaseConnectSlot();
 	// delete while client still valid, because in views blocks reference parent client
 	for (auto block : m_dataBlocks->blocks())
 	{
@@ -94,6 +214,96 @@ QUaProperty * QUaModbusClient::keepConnecting()
 	return m_keepConnecting;
 }
 
+QUaProperty * QUaModbusClient::timeout()
+{
+	QMutexLocker locker(&this->m_mutex);
+	if (!m_timeout)
+	{
+		m_timeout = this->browseChild<QUaProperty>("Timeout");
+	}
+	return m_timeout;
+}
+
+QUaProperty * QUaModbusClient::retries()
+{
+	QMutexLocker locker(&this->m_mutex);
+	if (!m_retries)
+	{
+		m_retries = this->browseChild<QUaProperty>("Retries");
+	}
+	return m_retries;
+}
+
+QUaProperty * QUaModbusClient::adaptiveTimeout()
+{
+	QMutexLocker locker(&this->m_mutex);
+	if (!m_adaptiveTimeout)
+	{
+		m_adaptiveTimeout = this->browseChild<QUaProperty>("AdaptiveTimeout");
+	}
+	return m_adaptiveTimeout;
+}
+
+QUaProperty * QUaModbusClient::reconnectDelay()
+{
+	QMutexLocker locker(&this->m_mutex);
+	if (!m_reconnectDelay)
+	{
+		m_reconnectDelay = this->browseChild<QUaProperty>("ReconnectDelay");
+	}
+	return m_reconnectDelay;
+}
+
+QUaProperty * QUaModbusClient::maxReconnectDelay()
+{
+	QMutexLocker locker(&this->m_mutex);
+	if (!m_maxReconnectDelay)
+	{
+		m_maxReconnectDelay = this->browseChild<QUaProperty>("MaxReconnectDelay");
+	}
+	return m_maxReconnectDelay;
+}
+
+QUaProperty * QUaModbusClient::breakerThreshold()
+{
+	QMutexLocker locker(&this->m_mutex);
+	if (!m_breakerThreshold)
+	{
+		m_breakerThreshold = this->browseChild<QUaProperty>("BreakerThreshold");
+	}
+	return m_breakerThreshold;
+}
+
+QUaProperty * QUaModbusClient::breakerProbeInterval()
+{
+	QMutexLocker locker(&this->m_mutex);
+	if (!m_breakerProbeInterval)
+	{
+		m_breakerProbeInterval = this->browseChild<QUaProperty>("BreakerProbeInterval");
+	}
+	return m_breakerProbeInterval;
+}
+
+QUaProperty * QUaModbusClient::minSamplingTime()
+{
+	QMutexLocker locker(&this->m_mutex);
+	if (!m_minSamplingTime)
+	{
+		m_minSamplingTime = this->browseChild<QUaProperty>("MinSamplingTime");
+	}
+	return m_minSamplingTime;
+}
+
+QUaProperty * QUaModbusClient::enabled()
+{
+	QMutexLocker locker(&this->m_mutex);
+	if (!m_enabled)
+	{
+		m_enabled = this->browseChild<QUaProperty>("Enabled");
+	}
+	return m_enabled;
+}
+
 QUaBaseDataVariable * QUaModbusClient::state()
 {
 	QMutexLocker locker(&this->m_mutex);
@@ -114,6 +324,36 @@ QUaBaseDataVariable * QUaModbusClient::lastError()
 	return m_lastError;
 }
 
+QUaBaseDataVariable * QUaModbusClient::writeQueueDelay()
+{
+	QMutexLocker locker(&this->m_mutex);
+	if (!m_writeQueueDelay)
+	{
+		m_writeQueueDelay = this->browseChild<QUaBaseDataVariable>("WriteQueueDelay");
+	}
+	return m_writeQueueDelay;
+}
+
+QUaBaseDataVariable * QUaModbusClient::effectiveTimeout()
+{
+	QMutexLocker locker(&this->m_mutex);
+	if (!m_effectiveTimeout)
+	{
+		m_effectiveTimeout = this->browseChild<QUaBaseDataVariable>("EffectiveTimeout");
+	}
+	return m_effectiveTimeout;
+}
+
+QUaBaseDataVariable * QUaModbusClient::breakerState()
+{
+	QMutexLocker locker(&this->m_mutex);
+	if (!m_breakerState)
+	{
+		m_breakerState = this->browseChild<QUaBaseDataVariable>("BreakerState");
+	}
+	return m_breakerState;
+}
+
 QUaModbusDataBlockList * QUaModbusClient::dataBlocks()
 {
 	QMutexLocker locker(&this->m_mutex);
@@ -139,15 +379,43 @@ void QUaModbusClient::connectDevice()
 	{
 		return;
 	}
+	m_reconnectTimer.stop();
+	// not until enabled again
+	if (!this->getEnabled())
+	{
+		return;
+	}
+	// wait for a free slot if too many clients are connecting
+	if (!m_holdsConnectSlot)
+	{
+		if (m_maxConcurrentConnects > 0 && m_connectingCount >= m_maxConcurrentConnects)
+		{
+			if (!m_connectQueue.contains(this))
+			{
+				m_connectQueue.append(this);
+			}
+			return;
+		}
+		m_holdsConnectSlot = true;
+		m_connectingCount++;
+	}
 	// exec in thread, for thread-safety
 	m_workerThread.execInThread([this]() {
 		m_modbusClient->connectDevice();
 	});
+	if (m_connectTimeout > 0)
+	{
+		m_connectTimer.start(m_connectTimeout);
+	}
 }
 
 void QUaModbusClient::disconnectDevice()
 {
 	QMutexLocker locker(&m_mutex);
+	// stop trying
+	m_reconnectTimer.stop();
+	m_connectTimer.stop();
+	m_connectQueue.removeAll(this);
 	// check if same
 	if (this->getState() == QModbusState::UnconnectedState)
 	{
@@ -167,6 +435,128 @@ void QUaModbusClient::disconnectDevice()
 	});
 }
 
+QString QUaModbusClient::slaveStatistics()
+{
+	QString strCsv = tr("ServerAddress,Requests,Responses,Errors,Timeouts,LastResponseTime,AverageResponseTime,MaxResponseTime,TurnaroundTime,WriteQueueTime,MaxWriteQueueTime,BreakerTrips,BreakerState\n");
+	if (!m_scheduler)
+	{
+		return strCsv;
+	}
+	auto stats = m_scheduler->slaveStats();
+	for (auto it = stats.begin(); it != stats.end(); ++it)
+	{
+		strCsv += QString("%1,%2,%3,%4,%5,%6,%7,%8,%9,%10,%11,%12,%13\n")
+			.arg(it.key())
+			.arg(it.value().requests)
+			.arg(it.value().responses)
+			.arg(it.value().errors)
+			.arg(it.value().timeouts)
+			.arg(it.value().lastResponseTime, 0, 'f', 3)
+			.arg(it.value().avgResponseTime , 0, 'f', 3)
+			.arg(it.value().maxResponseTime , 0, 'f', 3)
+			.arg(it.value().turnaroundTime  , 0, 'f', 3)
+			.arg(it.value().writeQueueTime  , 0, 'f', 3)
+			.arg(it.value().maxWriteQueueTime, 0, 'f', 3)
+			.arg(it.value().breakerTrips)
+			.arg(QMetaEnum::fromType<QUaModbusScheduler::BreakerState>().valueToKey(it.value().breakerState));
+	}
+	return strCsv;
+}
+
+void QUaModbusClient::resetSlaveStatistics()
+{
+	if (!m_scheduler)
+	{
+		return;
+	}
+	m_scheduler->resetSlaveStats();
+}
+
+QString QUaModbusClient::capacityPlan()
+{
+	QString strCsv = tr("Block,ServerAddress,TransactionTime,SamplingTime,AchievableCycle,Feasible\n");
+	auto utilization = this->expectedUtilization() / 100.0;
+	auto blocks = this->dataBlocks()->blocks();
+	for (auto block : blocks)
+	{
+		auto serverAddress   = block->getServerAddress() < 0 ? this->getServerAddress() : block->getServerAddress();
+		auto transactionTime = this->blockTransactionTime(block);
+		auto samplingTime    = block->getSamplingTime();
+		if (transactionTime < 0.0)
+		{
+			strCsv += QString("%1,%2,,%3,,%4\n")
+				.arg(block->browseName().name())
+				.arg(serverAddress)
+				.arg(samplingTime)
+				.arg(tr("Unknown"));
+			continue;
+		}
+		// when oversubscribed all cycles stretch proportionally (fair scheduling)
+		auto achievableCycle = qMax((double)samplingTime, qMax(transactionTime, samplingTime * utilization));
+		// modbus limits the size of a single read
+		auto type    = block->getType();
+		auto maxSize = type == QModbusDataBlockType::Coils || type == QModbusDataBlockType::DiscreteInputs ? 2000u : 125u;
+		bool isFeasible = block->getSize() <= maxSize && achievableCycle <= (double)samplingTime;
+		strCsv += QString("%1,%2,%3,%4,%5,%6\n")
+			.arg(block->browseName().name())
+			.arg(serverAddress)
+			.arg(transactionTime, 0, 'f', 3)
+			.arg(samplingTime)
+			.arg(achievableCycle, 0, 'f', 3)
+			.arg(isFeasible ? tr("Yes") : tr("No"));
+	}
+	return strCsv;
+}
+
+double QUaModbusClient::expectedUtilization()
+{
+	double utilization = 0.0;
+	auto blocks = this->dataBlocks()->blocks();
+	for (auto block : blocks)
+	{
+		auto transactionTime = this->blockTransactionTime(block);
+		auto samplingTime    = block->getSamplingTime();
+		if (transactionTime < 0.0 || samplingTime == 0)
+		{
+			continue;
+		}
+		utilization += transactionTime / (double)samplingTime;
+	}
+	return 100.0 * utilization;
+}
+
+double QUaModbusClient::expectedTransactionTime(const quint8 & serverAddress, const int & requestSize, const int & responseSize) const
+{
+	Q_UNUSED(requestSize);
+	Q_UNUSED(responseSize);
+	// no line model, use the measured round trip time if any
+	if (!m_scheduler)
+	{
+		return -1.0;
+	}
+	auto stats = m_scheduler->slaveStats();
+	if (!stats.contains(serverAddress) || stats[serverAddress].responses == 0)
+	{
+		return -1.0;
+	}
+	return stats[serverAddress].avgResponseTime;
+}
+
+double QUaModbusClient::blockTransactionTime(QUaModbusDataBlock * block) const
+{
+	auto type = block->getType();
+	auto size = static_cast<int>(block->getSize());
+	if (type == QModbusDataBlockType::Invalid || size == 0)
+	{
+		return -1.0;
+	}
+	// address, function, byte count, data, crc
+	auto dataSize = type == QModbusDataBlockType::Coils || type == QModbusDataBlockType::DiscreteInputs ?
+		(size + 7) / 8 : 2 * size;
+	auto serverAddress = block->getServerAddress() < 0 ? this->getServerAddress() : static_cast<quint8>(block->getServerAddress());
+	return this->expectedTransactionTime(serverAddress, 8, 5 + dataSize);
+}
+
 quint8 QUaModbusClient::getServerAddress() const
 {
 	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
@@ -193,6 +583,199 @@ void QUaModbusClient::setKeepConnecting(const bool & keepConnecting)
 	this->on_keepConnectingChanged(keepConnecting, true);
 }
 
+int QUaModbusClient::getTimeout() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
+	return const_cast<QUaModbusClient*>(this)->timeout()->value().toInt();
+}
+
+void QUaModbusClient::setTimeout(const int & timeout)
+{
+	QMutexLocker locker(&m_mutex);
+	this->timeout()->setValue(timeout);
+	this->on_timeoutChanged(timeout, true);
+}
+
+int QUaModbusClient::getRetries() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
+	return const_cast<QUaModbusClient*>(this)->retries()->value().toInt();
+}
+
+void QUaModbusClient::setRetries(const int & retries)
+{
+	QMutexLocker locker(&m_mutex);
+	this->retries()->setValue(retries);
+	this->on_retriesChanged(retries, true);
+}
+
+bool QUaModbusClient::getAdaptiveTimeout() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
+	return const_cast<QUaModbusClient*>(this)->adaptiveTimeout()->value().toBool();
+}
+
+void QUaModbusClient::setAdaptiveTimeout(const bool & adaptiveTimeout)
+{
+	QMutexLocker locker(&m_mutex);
+	this->adaptiveTimeout()->setValue(adaptiveTimeout);
+	this->on_adaptiveTimeoutChanged(adaptiveTimeout, true);
+}
+
+int QUaModbusClient::getEffectiveTimeout() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
+	return const_cast<QUaModbusClient*>(this)->effectiveTimeout()->value().toInt();
+}
+
+quint32 QUaModbusClient::getReconnectDelay() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
+	return const_cast<QUaModbusClient*>(this)->reconnectDelay()->value().value<quint32>();
+}
+
+void QUaModbusClient::setReconnectDelay(const quint32 & reconnectDelay)
+{
+	QMutexLocker locker(&m_mutex);
+	this->reconnectDelay()->setValue(reconnectDelay);
+	this->on_reconnectDelayChanged(reconnectDelay, true);
+}
+
+quint32 QUaModbusClient::getMaxReconnectDelay() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
+	return const_cast<QUaModbusClient*>(this)->maxReconnectDelay()->value().value<quint32>();
+}
+
+void QUaModbusClient::setMaxReconnectDelay(const quint32 & maxReconnectDelay)
+{
+	QMutexLocker locker(&m_mutex);
+	this->maxReconnectDelay()->setValue(maxReconnectDelay);
+	this->on_maxReconnectDelayChanged(maxReconnectDelay, true);
+}
+
+quint32 QUaModbusClient::getBreakerThreshold() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
+	return const_cast<QUaModbusClient*>(this)->breakerThreshold()->value().value<quint32>();
+}
+
+void QUaModbusClient::setBreakerThreshold(const quint32 & breakerThreshold)
+{
+	QMutexLocker locker(&m_mutex);
+	this->breakerThreshold()->setValue(breakerThreshold);
+	this->on_breakerThresholdChanged(breakerThreshold, true);
+}
+
+quint32 QUaModbusClient::getBreakerProbeInterval() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
+	return const_cast<QUaModbusClient*>(this)->breakerProbeInterval()->value().value<quint32>();
+}
+
+void QUaModbusClient::setBreakerProbeInterval(const quint32 & breakerProbeInterval)
+{
+	QMutexLocker locker(&m_mutex);
+	this->breakerProbeInterval()->setValue(breakerProbeInterval);
+	this->on_breakerProbeIntervalChanged(breakerProbeInterval, true);
+}
+
+quint32 QUaModbusClient::getMinSamplingTime() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
+	return const_cast<QUaModbusClient*>(this)->minSamplingTime()->value().value<quint32>();
+}
+
+void QUaModbusClient::setMinSamplingTime(const quint32 & minSamplingTime)
+{
+	QMutexLocker locker(&m_mutex);
+	this->minSamplingTime()->setValue(minSamplingTime);
+	this->on_minSamplingTimeChanged(minSamplingTime, true);
+}
+
+bool QUaModbusClient::getEnabled() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
+	return const_cast<QUaModbusClient*>(this)->enabled()->value().toBool();
+}
+
+void QUaModbusClient::setEnabled(const bool & enabled)
+{
+	QMutexLocker locker(&m_mutex);
+	this->enabled()->setValue(enabled);
+	this->on_enabledChanged(enabled, true);
+}
+
+QUaModbusScheduler::BreakerState QUaModbusClient::getBreakerState() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
+	return const_cast<QUaModbusClient*>(this)->breakerState()->value().value<QUaModbusScheduler::BreakerState>();
+}
+
+int QUaModbusClient::getMaxConcurrentConnects()
+{
+	return m_maxConcurrentConnects;
+}
+
+void QUaModbusClient::setMaxConcurrentConnects(const int & maxConcurrentConnects)
+{
+	m_maxConcurrentConnects = maxConcurrentConnects;
+}
+
+int QUaModbusClient::getConnectTimeout()
+{
+	return m_connectTimeout;
+}
+
+void QUaModbusClient::setConnectTimeout(const int & connectTimeout)
+{
+	m_connectTimeout = connectTimeout;
+}
+
+void QUaModbusClient::scheduleReconnect()
+{
+	if (m_reconnectTimer.isActive())
+	{
+		return;
+	}
+	// exponential backoff up to max, never a tight reconnect loop
+	double delay = qMax(
+		(double)QUaModbusClient::m_minReconnectDelay,
+		qMin(
+			(double)this->getMaxReconnectDelay(),
+			this->getReconnectDelay() * qPow(2.0, m_reconnectAttempts)
+		)
+	);
+	// equal jitter, half fixed and half random
+	delay = delay / 2.0 + QRandomGenerator::global()->bounded(delay / 2.0);
+	m_reconnectAttempts = qMin(m_reconnectAttempts + 1, 31);
+	m_reconnectTimer.start(qRound(delay));
+}
+
+void QUaModbusClient::releaseConnectSlot()
+{
+	if (!m_holdsConnectSlot)
+	{
+		return;
+	}
+	m_holdsConnectSlot = false;
+	m_connectingCount--;
+	// let the next waiting client connect
+	while (!m_connectQueue.isEmpty())
+	{
+		auto next = m_connectQueue.takeFirst();
+		if (!next)
+		{
+			continue;
+		}
+		next->connectDevice();
+		if (next->m_holdsConnectSlot)
+		{
+			break;
+		}
+	}
+}
+
 QModbusError QUaModbusClient::getLastError() const
 {
 	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
@@ -205,6 +788,12 @@ void QUaModbusClient::setLastError(const QModbusError & error)
 	this->on_errorChanged(error);
 }
 
+double QUaModbusClient::getWriteQueueDelay() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
+	return const_cast<QUaModbusClient*>(this)->writeQueueDelay()->value().toDouble();
+}
+
 QUaModbusClientList * QUaModbusClient::list() const
 {
 	QMutexLocker locker(&(const_cast<QUaModbusClient*>(this)->m_mutex));
@@ -238,6 +827,10 @@ void QUaModbusClient::resetModbusClient()
 	// subscribe to events
 	QObject::connect(m_modbusClient.data(), &QModbusClient::stateChanged , this, &QUaModbusClient::on_stateChanged, Qt::QueuedConnection);
 	QObject::connect(m_modbusClient.data(), &QModbusClient::errorOccurred, this, &QUaModbusClient::on_errorChanged, Qt::QueuedConnection);
+	// request timeout and retries
+	m_scheduler->setTimeout(this->getTimeout(), this->getAdaptiveTimeout());
+	m_modbusClient->setTimeout(m_scheduler->timeout());
+	m_modbusClient->setNumberOfRetries(this->getRetries());
 }
 
 QDomElement QUaModbusClient::toDomElement(QDomDocument & domDoc) const
@@ -256,6 +849,178 @@ void QUaModbusClient::fromDomElement(QDomElement & domElem, QQueue<QUaLog>& erro
 	Q_UNUSED(errorLogs);
 }
 
+void QUaModbusClient::toDomElementCommon(QDomElement & elemClient) const
+{
+	elemClient.setAttribute("Timeout"             , getTimeout             ());
+	elemClient.setAttribute("Retries"             , getRetries             ());
+	elemClient.setAttribute("AdaptiveTimeout"     , getAdaptiveTimeout     ());
+	elemClient.setAttribute("ReconnectDelay"      , getReconnectDelay      ());
+	elemClient.setAttribute("MaxReconnectDelay"   , getMaxReconnectDelay   ());
+	elemClient.setAttribute("BreakerThreshold"    , getBreakerThreshold    ());
+	elemClient.setAttribute("BreakerProbeInterval", getBreakerProbeInterval());
+	elemClient.setAttribute("MinSamplingTime"     , getMinSamplingTime     ());
+	elemClient.setAttribute("Enabled"             , getEnabled             ());
+}
+
+void QUaModbusClient::fromDomElementCommon(QDomElement & domElem, QQueue<QUaLog>& errorLogs)
+{
+	QString strBrowseName = this->browseName().name();
+	bool bOK;
+	// Timeout (optional)
+	if (domElem.hasAttribute("Timeout"))
+	{
+		auto timeout = domElem.attribute("Timeout").toInt(&bOK);
+		if (bOK)
+		{
+			this->setTimeout(timeout);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid Timeout attribute '%1' in Modbus client %2. Default value set.").arg(domElem.attribute("Timeout")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// Retries (optional)
+	if (domElem.hasAttribute("Retries"))
+	{
+		auto retries = domElem.attribute("Retries").toInt(&bOK);
+		if (bOK)
+		{
+			this->setRetries(retries);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid Retries attribute '%1' in Modbus client %2. Default value set.").arg(domElem.attribute("Retries")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// AdaptiveTimeout (optional)
+	if (domElem.hasAttribute("AdaptiveTimeout"))
+	{
+		auto adaptiveTimeout = (bool)domElem.attribute("AdaptiveTimeout").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setAdaptiveTimeout(adaptiveTimeout);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid AdaptiveTimeout attribute '%1' in Modbus client %2. Default value set.").arg(domElem.attribute("AdaptiveTimeout")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// ReconnectDelay (optional)
+	if (domElem.hasAttribute("ReconnectDelay"))
+	{
+		auto reconnectDelay = domElem.attribute("ReconnectDelay").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setReconnectDelay(reconnectDelay);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid ReconnectDelay attribute '%1' in Modbus client %2. Default value set.").arg(domElem.attribute("ReconnectDelay")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// MaxReconnectDelay (optional)
+	if (domElem.hasAttribute("MaxReconnectDelay"))
+	{
+		auto maxReconnectDelay = domElem.attribute("MaxReconnectDelay").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setMaxReconnectDelay(maxReconnectDelay);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid MaxReconnectDelay attribute '%1' in Modbus client %2. Default value set.").arg(domElem.attribute("MaxReconnectDelay")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// BreakerThreshold (optional)
+	if (domElem.hasAttribute("BreakerThreshold"))
+	{
+		auto breakerThreshold = domElem.attribute("BreakerThreshold").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setBreakerThreshold(breakerThreshold);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid BreakerThreshold attribute '%1' in Modbus client %2. Default value set.").arg(domElem.attribute("BreakerThreshold")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// BreakerProbeInterval (optional)
+	if (domElem.hasAttribute("BreakerProbeInterval"))
+	{
+		auto breakerProbeInterval = domElem.attribute("BreakerProbeInterval").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setBreakerProbeInterval(breakerProbeInterval);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid BreakerProbeInterval attribute '%1' in Modbus client %2. Default value set.").arg(domElem.attribute("BreakerProbeInterval")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// MinSamplingTime (optional)
+	if (domElem.hasAttribute("MinSamplingTime"))
+	{
+		auto minSamplingTime = domElem.attribute("MinSamplingTime").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setMinSamplingTime(minSamplingTime);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid MinSamplingTime attribute '%1' in Modbus client %2. Default value set.").arg(domElem.attribute("MinSamplingTime")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// Enabled (optional)
+	if (domElem.hasAttribute("Enabled"))
+	{
+		auto enabled = (bool)domElem.attribute("Enabled").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setEnabled(enabled);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid Enabled attribute '%1' in Modbus client %2. Default value set.").arg(domElem.attribute("Enabled")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+}
+
 void QUaModbusClient::on_serverAddressChanged(const QVariant & value, const bool& networkChange)
 {
 
@@ -263,8 +1028,15 @@ void QUaModbusClient::on_serverAddressChanged(const QVariant & value, const bool
 	{
 		return;
 	}
+	auto serverAddress = value.value<quint8>();
+	// show breaker of the new server
+	if (m_scheduler)
+	{
+		auto stats = m_scheduler->slaveStats();
+		this->breakerState()->setValue(stats.value(serverAddress).breakerState);
+	}
 	// emit
-	emit this->serverAddressChanged(value.value<quint8>());
+	emit this->serverAddressChanged(serverAddress);
 }
 
 void QUaModbusClient::on_keepConnectingChanged(const QVariant & value, const bool& networkChange)
@@ -274,29 +1046,206 @@ void QUaModbusClient::on_keepConnectingChanged(const QVariant & value, const boo
 	{
 		return;
 	}
+	auto keepConnecting = value.toBool();
+	// stop trying
+	if (!keepConnecting)
+	{
+		m_reconnectTimer.stop();
+	}
 	// emit
-	emit this->keepConnectingChanged(value.toBool());
+	emit this->keepConnectingChanged(keepConnecting);
+}
+
+void QUaModbusClient::on_timeoutChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto timeout  = value.toInt();
+	auto adaptive = this->getAdaptiveTimeout();
+	// set in thread, for thread-safety (scheduler applies it to the modbus client)
+	m_workerThread.execInThread([this, timeout, adaptive]() {
+		m_scheduler->setTimeout(timeout, adaptive);
+	});
+	// emit
+	emit this->timeoutChanged(timeout);
+}
+
+void QUaModbusClient::on_retriesChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto retries = value.toInt();
+	// set in thread, for thread-safety
+	m_workerThread.execInThread([this, retries]() {
+		m_modbusClient->setNumberOfRetries(retries);
+	});
+	// emit
+	emit this->retriesChanged(retries);
+}
+
+void QUaModbusClient::on_adaptiveTimeoutChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto adaptive = value.toBool();
+	auto timeout  = this->getTimeout();
+	// set in thread, for thread-safety (scheduler applies it to the modbus client)
+	m_workerThread.execInThread([this, timeout, adaptive]() {
+		m_scheduler->setTimeout(timeout, adaptive);
+	});
+	// emit
+	emit this->adaptiveTimeoutChanged(adaptive);
+}
+
+void QUaModbusClient::on_reconnectDelayChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto reconnectDelay = value.value<quint32>();
+	// do not allow less than minimum, would reconnect in a tight loop
+	if (reconnectDelay < QUaModbusClient::m_minReconnectDelay)
+	{
+		// set minumum
+		this->reconnectDelay()->setValue(QUaModbusClient::m_minReconnectDelay);
+		// emit
+		emit this->reconnectDelayChanged(QUaModbusClient::m_minReconnectDelay);
+		return;
+	}
+	// emit
+	emit this->reconnectDelayChanged(reconnectDelay);
+}
+
+void QUaModbusClient::on_maxReconnectDelayChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	// emit
+	emit this->maxReconnectDelayChanged(value.value<quint32>());
+}
+
+void QUaModbusClient::on_breakerThresholdChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto breakerThreshold = value.value<quint32>();
+	// set in thread, for thread-safety
+	m_workerThread.execInThread([this, breakerThreshold]() {
+		m_scheduler->setBreakerThreshold(static_cast<int>(breakerThreshold));
+	});
+	// emit
+	emit this->breakerThresholdChanged(breakerThreshold);
+}
+
+void QUaModbusClient::on_breakerProbeIntervalChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto breakerProbeInterval = value.value<quint32>();
+	// set in thread, for thread-safety
+	m_workerThread.execInThread([this, breakerProbeInterval]() {
+		m_scheduler->setProbeInterval(static_cast<int>(breakerProbeInterval));
+	});
+	// emit
+	emit this->breakerProbeIntervalChanged(breakerProbeInterval);
+}
+
+void QUaModbusClient::on_minSamplingTimeChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto minSamplingTime = value.value<quint32>();
+	// do not allow zero
+	if (minSamplingTime < 1)
+	{
+		// set minumum
+		this->minSamplingTime()->setValue(1);
+		// emit
+		emit this->minSamplingTimeChanged(1);
+		return;
+	}
+	// blocks faster than the new floor are slowed down
+	for (auto block : this->dataBlocks()->blocks())
+	{
+		if (block->getSamplingTime() < minSamplingTime)
+		{
+			block->setSamplingTime(minSamplingTime);
+		}
+	}
+	// emit
+	emit this->minSamplingTimeChanged(minSamplingTime);
+}
+
+void QUaModbusClient::on_enabledChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto enabled = value.toBool();
+	if (enabled)
+	{
+		// blocks check the client is enabled before starting their loops
+		this->dataBlocks()->startLoops();
+		if (this->getKeepConnecting())
+		{
+			this->connectDevice();
+		}
+	}
+	else
+	{
+		this->dataBlocks()->stopLoops();
+		this->disconnectDevice();
+	}
+	// emit
+	emit this->enabledChanged(enabled);
 }
 
 void QUaModbusClient::on_stateChanged(QModbusState state)
 {
 	this->setState(state);
-	// no error if connected correctly
+	// connection attempt finished
+	if (state != QModbusState::ConnectingState)
+	{
+		m_connectTimer.stop();
+		this->releaseConnectSlot();
+	}
+	// no error if connected correctly, start backoff over
 	if (state == QModbusState::ConnectedState)
 	{
 		this->setLastError(QModbusError::NoError);
+		m_reconnectAttempts = 0;
 	}
 	// make copy before modify because used in othe rplaces
 	bool disconnectRequested = m_disconnectRequested;
 	// only allow to write connection params if not connected
 	if (state == QModbusState::UnconnectedState)
 	{
+		// pending requests make no sense anymore
+		m_workerThread.execInThread([this]() {
+			m_scheduler->clear();
+		});
 		this->serverAddress()->setWriteAccess(true);
 		// keep connecting if desired
 		bool keepConnecting = this->keepConnecting()->value().toBool();
 		if (keepConnecting && !m_disconnectRequested)
 		{
-			this->connectDevice();
+			this->scheduleReconnect();
 		}
 		m_disconnectRequested = false;
 	}
@@ -334,7 +1283,35 @@ void QUaModbusClient::on_errorChanged(QModbusError error)
 {
 	// NOTe : setLastError call this, avoid recursion
 	this->lastError()->setValue(error);
+	// connection attempt failed (e.g. serial port did not open, no state change)
+	if (error == QModbusError::ConnectionError)
+	{
+		this->releaseConnectSlot();
+		if (this->getState() == QModbusState::UnconnectedState && this->getKeepConnecting() && !m_disconnectRequested)
+		{
+			this->scheduleReconnect();
+		}
+	}
 	//// TODO : send UA event
 	// emit
 	emit this->lastErrorChanged(error);
-}
\ No newline at end of file
+}
+
+void QUaModbusClient::on_writeDispatched(const double & queueTime)
+{
+	this->writeQueueDelay()->setValue(queueTime);
+}
+
+void QUaModbusClient::on_timeoutAdapted(const int & timeout)
+{
+	this->effectiveTimeout()->setValue(timeout);
+}
+
+void QUaModbusClient::on_breakerStateChanged(const quint8 & serverAddress, const QUaModbusScheduler::BreakerState & state)
+{
+	if (serverAddress != this->getServerAddress())
+	{
+		return;
+	}
+	this->breakerState()->setValue(state);
+}
@@ -7,6 +7,8 @@
 #include <QSerialPort>
 #include <QMutex>
 #include <QSharedPointer>
+#include <QPointer>
+#include <QTimer>
 
 #include <QLambdaThreadWorker>
 
@@ -23,6 +25,7 @@
 #include <QDomElement>
 
 #include "quamodbusdatablocklist.h"
+#include "quamodbusscheduler.h"
 
 class QUaModbusClientList;
 class QUaModbusDataBlock;
@@ -47,10 +50,22 @@ class QUaModbusClient : public QUaBaseObjectProtected
 	Q_PROPERTY(QUaProperty * Type           READ type          )
 	Q_PROPERTY(QUaProperty * ServerAddress  READ serverAddress )
 	Q_PROPERTY(QUaProperty * KeepConnecting READ keepConnecting)
+	Q_PROPERTY(QUaProperty * Timeout         READ timeout        )
+	Q_PROPERTY(QUaProperty * Retries         READ retries        )
+	Q_PROPERTY(QUaProperty * AdaptiveTimeout READ adaptiveTimeout)
+	Q_PROPERTY(QUaProperty * ReconnectDelay    READ reconnectDelay   )
+	Q_PROPERTY(QUaProperty * MaxReconnectDelay READ maxReconnectDelay)
+	Q_PROPERTY(QUaProperty * BreakerThreshold     READ breakerThreshold    )
+	Q_PROPERTY(QUaProperty * BreakerProbeInterval READ breakerProbeInterval)
+	Q_PROPERTY(QUaProperty * MinSamplingTime READ minSamplingTime)
+	Q_PROPERTY(QUaProperty * Enabled         READ enabled        )
 
 	// UA variables
 	Q_PROPERTY(QUaBaseDataVariable * State     READ state    )
 	Q_PROPERTY(QUaBaseDataVariable * LastError READ lastError)
+	Q_PROPERTY(QUaBaseDataVariable * WriteQueueDelay READ writeQueueDelay)
+	Q_PROPERTY(QUaBaseDataVariable * EffectiveTimeout READ effectiveTimeout)
+	Q_PROPERTY(QUaBaseDataVariable * BreakerState     READ breakerState    )
 
 	// UA objects
 	Q_PROPERTY(QUaModbusDataBlockList * DataBlocks READ dataBlocks)
@@ -72,11 +87,23 @@ public:
 	QUaProperty * type();
 	QUaProperty * serverAddress();
 	QUaProperty * keepConnecting();
+	QUaProperty * timeout();
+	QUaProperty * retries();
+	QUaProperty * adaptiveTimeout();
+	QUaProperty * reconnectDelay();
+	QUaProperty * maxReconnectDelay();
+	QUaProperty * breakerThreshold();
+	QUaProperty * breakerProbeInterval();
+	QUaProperty * minSamplingTime();
+	QUaProperty * enabled();
 
 	// UA variables
 
 	QUaBaseDataVariable * state();
 	QUaBaseDataVariable * lastError();
+	QUaBaseDataVariable * writeQueueDelay();
+	QUaBaseDataVariable * effectiveTimeout();
+	QUaBaseDataVariable * breakerState();
 
 	// UA objects
 
@@ -87,6 +114,13 @@ public:
 	Q_INVOKABLE void remove();
 	Q_INVOKABLE void connectDevice();
 	Q_INVOKABLE void disconnectDevice();
+	// CSV with the request statistics of each modbus server (unit id) on the bus
+	Q_INVOKABLE QString slaveStatistics();
+	Q_INVOKABLE void    resetSlaveStatistics();
+	// CSV with the expected transaction time and achievable cycle of each block
+	Q_INVOKABLE QString capacityPlan();
+	// expected bus utilization (percentage) for the configured blocks, over 100 is infeasible
+	Q_INVOKABLE double  expectedUtilization();
 
 	// C++ API
 
@@ -101,9 +135,64 @@ public:
 	bool   getKeepConnecting() const;
 	void   setKeepConnecting(const bool &keepConnecting);
 
+	// time (ms) to wait for a reply, upper bound in adaptive mode
+	int    getTimeout() const;
+	void   setTimeout(const int &timeout);
+
+	int    getRetries() const;
+	void   setRetries(const int &retries);
+
+	// NOTE : derive the timeout from the measured round trip time (smoothed plus 4 deviations)
+	bool   getAdaptiveTimeout() const;
+	void   setAdaptiveTimeout(const bool &adaptiveTimeout);
+
+	// timeout (ms) currently used by the modbus client
+	int    getEffectiveTimeout() const;
+
+	// NOTE : with KeepConnecting, wait before reconnecting, doubling on each failure up to the max (ms)
+	//        half of the wait is random so clients that failed together do not retry together
+	quint32 getReconnectDelay() const;
+	void    setReconnectDelay(const quint32 &reconnectDelay);
+
+	quint32 getMaxReconnectDelay() const;
+	void    setMaxReconnectDelay(const quint32 &maxReconnectDelay);
+
+	// NOTE : circuit breaker of each server (unit id), after this many consecutive failures
+	//        polling stops and only a probe read is sent every probe interval (ms) until one is answered
+	quint32 getBreakerThreshold() const;
+	void    setBreakerThreshold(const quint32 &breakerThreshold);
+
+	quint32 getBreakerProbeInterval() const;
+	void    setBreakerProbeInterval(const quint32 &breakerProbeInterval);
+
+	// NOTE : lowest sampling time (ms) allowed to the blocks of this client, at least 1
+	//        blocks polled faster than 50 ms use precise timers, only lower it for fast devices
+	quint32 getMinSamplingTime() const;
+	void    setMinSamplingTime(const quint32 &minSamplingTime);
+
+	// NOTE : a disabled client is disconnected and its blocks are not polled, config is kept
+	bool getEnabled() const;
+	void setEnabled(const bool &enabled);
+
+	// breaker of the client server address, see slaveStatistics for the others on the bus
+	QUaModbusScheduler::BreakerState getBreakerState() const;
+
+	// NOTE : global limit of connection attempts in progress (all clients), 0 is unlimited
+	//        clients over the limit connect as soon as another attempt finishes
+	static int  getMaxConcurrentConnects();
+	static void setMaxConcurrentConnects(const int &maxConcurrentConnects);
+
+	// NOTE : global time (ms) a connection attempt can take before it is aborted, 0 waits for the OS
+	//        hosts that never answer would otherwise hold a connection slot for minutes
+	static int  getConnectTimeout();
+	static void setConnectTimeout(const int &connectTimeout);
+
 	QModbusError getLastError() const;
 	void         setLastError(const QModbusError &error);
 
+	// time (ms) the last write waited for the bus
+	double getWriteQueueDelay() const;
+
 	QUaModbusClientList * list() const;
 
     // Fix for GCC : cannot be protected or "virtual is protected within this context" error
@@ -113,6 +202,15 @@ signals:
 	// C++ API
 	void serverAddressChanged (const quint8 &serverAddress );
 	void keepConnectingChanged(const bool   &keepConnecting);
+	void timeoutChanged        (const int    &timeout        );
+	void retriesChanged        (const int    &retries        );
+	void adaptiveTimeoutChanged(const bool   &adaptiveTimeout);
+	void reconnectDelayChanged   (const quint32 &reconnectDelay   );
+	void maxReconnectDelayChanged(const quint32 &maxReconnectDelay);
+	void breakerThresholdChanged    (const quint32 &breakerThreshold    );
+	void breakerProbeIntervalChanged(const quint32 &breakerProbeInterval);
+	void minSamplingTimeChanged     (const quint32 &minSamplingTime     );
+	void enabledChanged(const bool &enabled);
 	void stateChanged    (const QModbusState &state);
 	void lastErrorChanged(const QModbusError &error);
 	void aboutToDestroy();
@@ -121,25 +219,74 @@ protected:
 	QMutex m_mutex;
 	QLambdaThreadWorker           m_workerThread;
 	QSharedPointer<QModbusClient> m_modbusClient;
+	// NOTE : all requests must go through the scheduler, only use in thread
+	QSharedPointer<QUaModbusScheduler> m_scheduler;
+
+	// expected time (ms) the bus is taken by a transaction, negative if unknown
+	virtual double expectedTransactionTime(const quint8 &serverAddress, const int &requestSize, const int &responseSize) const;
 
 	// XML import / export
 	// NOTE : cannot be pure virtual, else moc fails
 	virtual QDomElement toDomElement  (QDomDocument & domDoc) const;
 	virtual void        fromDomElement(QDomElement  & domElem, QQueue<QUaLog>& errorLogs);
+	// attributes common to all clients, optional so older files still load
+	void toDomElementCommon  (QDomElement & elemClient) const;
+	void fromDomElementCommon(QDomElement & domElem, QQueue<QUaLog>& errorLogs);
+
+	// NOTE : set in thread when the disconnection is requested, to tell it apart from a connection loss
+	bool m_disconnectRequested;
+
+protected slots:
+	void on_stateChanged(QModbusState state);
+	void on_errorChanged(QModbusError error);
 
 private slots:
 	void on_serverAddressChanged (const QVariant & value, const bool& networkChange);
 	void on_keepConnectingChanged(const QVariant & value, const bool& networkChange);
-	void on_stateChanged(QModbusState state);
-	void on_errorChanged(QModbusError error);
+	void on_timeoutChanged        (const QVariant & value, const bool& networkChange);
+	void on_retriesChanged        (const QVariant & value, const bool& networkChange);
+	void on_adaptiveTimeoutChanged(const QVariant & value, const bool& networkChange);
+	void on_reconnectDelayChanged   (const QVariant & value, const bool& networkChange);
+	void on_maxReconnectDelayChanged(const QVariant & value, const bool& networkChange);
+	void on_breakerThresholdChanged    (const QVariant & value, const bool& networkChange);
+	void on_breakerProbeIntervalChanged(const QVariant & value, const bool& networkChange);
+	void on_minSamplingTimeChanged     (const QVariant & value, const bool& networkChange);
+	void on_enabledChanged(const QVariant & value, const bool& networkChange);
+	void on_writeDispatched(const double &queueTime);
+	void on_timeoutAdapted (const int &timeout);
+	void on_breakerStateChanged(const quint8 &serverAddress, const QUaModbusScheduler::BreakerState &state);
 
 private:
-	bool m_disconnectRequested;
+	// reconnect backoff and connection slot, only used in ua server thread
+	int    m_reconnectAttempts;
+	QTimer m_reconnectTimer;
+	QTimer m_connectTimer;
+	bool   m_holdsConnectSlot;
+	static int m_connectingCount;
+	static int m_maxConcurrentConnects;
+	static int m_connectTimeout;
+	static quint32 m_minReconnectDelay;
+	static QList<QPointer<QUaModbusClient>> m_connectQueue;
+	void scheduleReconnect();
+	void releaseConnectSlot();
+	double blockTransactionTime(QUaModbusDataBlock * block) const;
 	QUaProperty* m_type;
 	QUaProperty* m_serverAddress;
 	QUaProperty* m_keepConnecting;
+	QUaProperty* m_timeout;
+	QUaProperty* m_retries;
+	QUaProperty* m_adaptiveTimeout;
+	QUaProperty* m_reconnectDelay;
+	QUaProperty* m_maxReconnectDelay;
+	QUaProperty* m_breakerThreshold;
+	QUaProperty* m_breakerProbeInterval;
+	QUaProperty* m_minSamplingTime;
+	QUaProperty* m_enabled;
 	QUaBaseDataVariable* m_state;
 	QUaBaseDataVariable* m_lastError;
+	QUaBaseDataVariable* m_writeQueueDelay;
+	QUaBaseDataVariable* m_effectiveTimeout;
+	QUaBaseDataVariable* m_breakerState;
 	QUaModbusDataBlockList* m_dataBlocks;
 };
 
@@ -12,7 +12,8 @@ HEADERS += \
 	$$PWD/quamodbusdatablocklist.h \
 	$$PWD/quamodbusdatablock.h \
 	$$PWD/quamodbusvaluelist.h \
-	$$PWD/quamodbusvalue.h
+	$$PWD/quamodbusvalue.h \
+	$$PWD/quamodbusscheduler.h
 
 SOURCES += \
 	$$PWD/quamodbusclientlist.cpp \
@@ -22,4 +23,5 @@ SOURCES += \
 	$$PWD/quamodbusdatablocklist.cpp \
 	$$PWD/quamodbusdatablock.cpp \
 	$$PWD/quamodbusvaluelist.cpp \
-	$$PWD/quamodbusvalue.cpp
+	$$PWD/quamodbusvalue.cpp \
+	$$PWD/quamodbusscheduler.cpp
@@ -120,9 +120,9 @@ QString QUaModbusClientList::csvClients()
 {
 	QString strCsv;
 #ifndef QUA_ACCESS_CONTROL
-	strCsv += QString("%1, %2, %3, %4, %5, %6\n")
-#else
 	strCsv += QString("%1, %2, %3, %4, %5, %6, %7\n")
+#else
+	strCsv += QString("%1, %2, %3, %4, %5, %6, %7, %8\n")
 #endif // !QUA_ACCESS_CONTROL
 		.arg(tr("Name"          ))
 		.arg(tr("Type"          ))
@@ -130,6 +130,7 @@ QString QUaModbusClientList::csvClients()
 		.arg(tr("KeepConnecting"))
 		.arg(tr("NetworkAddress"))
 		.arg(tr("NetworkPort"   ))
+		.arg(tr("Enabled"       ))
 #ifndef QUA_ACCESS_CONTROL
 		;
 #else
@@ -141,9 +142,9 @@ QString QUaModbusClientList::csvClients()
 	{
 		auto strType = QString(QMetaEnum::fromType<QModbusClientType>().valueToKey(clientTcp->getType()));
 #ifndef QUA_ACCESS_CONTROL
-		strCsv += QString("%1, %2, %3, %4, %5, %6\n")
-#else
 		strCsv += QString("%1, %2, %3, %4, %5, %6, %7\n")
+#else
+		strCsv += QString("%1, %2, %3, %4, %5, %6, %7, %8\n")
 #endif // !QUA_ACCESS_CONTROL
 			.arg(clientTcp->browseName().name())
 			.arg(strType)
@@ -151,6 +152,7 @@ QString QUaModbusClientList::csvClients()
 			.arg(clientTcp->getKeepConnecting())
 			.arg(clientTcp->getNetworkAddress())
 			.arg(clientTcp->getNetworkPort   ())
+			.arg(clientTcp->getEnabled       ())
 #ifndef QUA_ACCESS_CONTROL
 			;
 #else
@@ -158,9 +160,9 @@ QString QUaModbusClientList::csvClients()
 #endif // !QUA_ACCESS_CONTROL	
 	}
 #ifndef QUA_ACCESS_CONTROL
-	strCsv += QString("%1, %2, %3, %4, %5, %6, %7, %8, %9\n")
-#else
 	strCsv += QString("%1, %2, %3, %4, %5, %6, %7, %8, %9, %10\n")
+#else
+	strCsv += QString("%1, %2, %3, %4, %5, %6, %7, %8, %9, %10, %11\n")
 #endif // !QUA_ACCESS_CONTROL
 	
 		.arg(tr("Name"          ))
@@ -172,6 +174,7 @@ QString QUaModbusClientList::csvClients()
 		.arg(tr("BaudRate"      ))
 		.arg(tr("DataBits"      ))
 		.arg(tr("StopBits"      ))
+		.arg(tr("Enabled"       ))
 #ifndef QUA_ACCESS_CONTROL
 		;
 #else
@@ -186,9 +189,9 @@ QString QUaModbusClientList::csvClients()
 		auto strDataBits = QString(QMetaEnum::fromType<QDataBits>().valueToKey(clientSerial->getDataBits()));
 		auto strStopBits = QString(QMetaEnum::fromType<QStopBits>().valueToKey(clientSerial->getStopBits()));
 #ifndef QUA_ACCESS_CONTROL
-		strCsv += QString("%1, %2, %3, %4, %5, %6, %7, %8, %9\n")
-#else
 		strCsv += QString("%1, %2, %3, %4, %5, %6, %7, %8, %9, %10\n")
+#else
+		strCsv += QString("%1, %2, %3, %4, %5, %6, %7, %8, %9, %10, %11\n")
 #endif // !QUA_ACCESS_CONTROL	
 			.arg(clientSerial->browseName().name())
 			.arg(strType)
@@ -199,6 +202,7 @@ QString QUaModbusClientList::csvClients()
 			.arg(strBaudRate)
 			.arg(strDataBits)
 			.arg(strStopBits)
+			.arg(clientSerial->getEnabled())
 #ifndef QUA_ACCESS_CONTROL
 			;
 #else
@@ -212,16 +216,18 @@ QString QUaModbusClientList::csvBlocks()
 {
 	QString strCsv;
 #ifndef QUA_ACCESS_CONTROL
-	strCsv += QString("%1, %2, %3, %4, %5, %6\n")
+	strCsv += QString("%1, %2, %3, %4, %5, %6, %7, %8\n")
 #else
-	strCsv += QString("%1, %2, %3, %4, %5, %6, %7\n")
+	strCsv += QString("%1, %2, %3, %4, %5, %6, %7, %8, %9\n")
 #endif // !QUA_ACCESS_CONTROL
-		.arg(tr("Name"        ))
-		.arg(tr("Client"      ))
-		.arg(tr("Type"        ))
-		.arg(tr("Address"     ))
-		.arg(tr("Size"        ))
-		.arg(tr("SamplingTime"))
+		.arg(tr("Name"         ))
+		.arg(tr("Client"       ))
+		.arg(tr("Type"         ))
+		.arg(tr("Address"      ))
+		.arg(tr("Size"         ))
+		.arg(tr("SamplingTime" ))
+		.arg(tr("ServerAddress"))
+		.arg(tr("Enabled"      ))
 #ifndef QUA_ACCESS_CONTROL
 		;
 #else
@@ -235,9 +241,9 @@ QString QUaModbusClientList::csvBlocks()
 		{
 			auto strType = QString(QMetaEnum::fromType<QModbusDataBlockType>().valueToKey(block->getType()));
 #ifndef QUA_ACCESS_CONTROL
-			strCsv += QString("%1, %2, %3, %4, %5, %6\n")
+			strCsv += QString("%1, %2, %3, %4, %5, %6, %7, %8\n")
 #else
-			strCsv += QString("%1, %2, %3, %4, %5, %6, %7\n")
+			strCsv += QString("%1, %2, %3, %4, %5, %6, %7, %8, %9\n")
 #endif // !QUA_ACCESS_CONTROL
 				.arg(block->browseName().name())
 				.arg(client->browseName().name())
@@ -245,6 +251,8 @@ QString QUaModbusClientList::csvBlocks()
 				.arg(block->getAddress())
 				.arg(block->getSize())
 				.arg(block->getSamplingTime())
+				.arg(block->getServerAddress())
+				.arg(block->getEnabled())
 #ifndef QUA_ACCESS_CONTROL
 				;
 #else
@@ -259,15 +267,16 @@ QString QUaModbusClientList::csvValues()
 {
 	QString strCsv;
 #ifndef QUA_ACCESS_CONTROL
-	strCsv += QString("%1, %2, %3, %4, %5\n")
-#else
 	strCsv += QString("%1, %2, %3, %4, %5, %6\n")
+#else
+	strCsv += QString("%1, %2, %3, %4, %5, %6, %7\n")
 #endif // !QUA_ACCESS_CONTROL
 		.arg(tr("Name"))
 		.arg(tr("Client"))
 		.arg(tr("Block"))
 		.arg(tr("Type"))
 		.arg(tr("AddressOffset"))
+		.arg(tr("Enabled"))
 #ifndef QUA_ACCESS_CONTROL
 		;
 #else
@@ -284,15 +293,16 @@ QString QUaModbusClientList::csvValues()
 			{
 				auto strType = QString(QMetaEnum::fromType<QModbusValueType>().valueToKey(value->getType()));
 #ifndef QUA_ACCESS_CONTROL
-				strCsv += QString("%1, %2, %3, %4, %5\n")
-#else
 				strCsv += QString("%1, %2, %3, %4, %5, %6\n")
+#else
+				strCsv += QString("%1, %2, %3, %4, %5, %6, %7\n")
 #endif // !QUA_ACCESS_CONTROL
 					.arg(value->browseName().name())
 					.arg(client->browseName().name())
 					.arg(block->browseName().name())
 					.arg(strType)
 					.arg(value->getAddressOffset())
+					.arg(value->getEnabled())
 #ifndef QUA_ACCESS_CONTROL
 					;
 #else
@@ -394,6 +404,25 @@ QQueue<QUaLog> QUaModbusClientList::setCsvClients(QString strCsvClients)
 						QUaLogCategory::Serialization
 					);
 				}
+				// get enabled (optional column, older files do not have it)
+				bool enabled = true;
+#ifndef QUA_ACCESS_CONTROL
+				if (listCols.count() > 6)
+#else
+				if (listCols.count() > 7)
+#endif // !QUA_ACCESS_CONTROL
+				{
+					enabled = (bool)listCols.at(6).trimmed().toUInt(&bOK);
+					if (!bOK)
+					{
+						enabled = true;
+						errorLogs << QUaLog(
+							tr("Invalid Enabled '%1' in row [%2]. Default value set.").arg(listCols.at(6).trimmed()).arg(strRow),
+							QUaLogLevel::Warning,
+							QUaLogCategory::Serialization
+						);
+					}
+				}
 				// check if tcp client exists
 				auto clientTcp = this->browseChild<QUaModbusTcpClient>(strBrowseName);
 				if (clientTcp)
@@ -444,9 +473,10 @@ QQueue<QUaLog> QUaModbusClientList::setCsvClients(QString strCsvClients)
 				clientTcp->setKeepConnecting(keepConnecting);
 				clientTcp->setNetworkAddress(networkAddress);
 				clientTcp->setNetworkPort   (networkPort   );
+				clientTcp->setEnabled       (enabled       );
 #ifdef QUA_ACCESS_CONTROL
-				// permissions are optional (can be empty)
-				auto permsBrowseName = listCols.at(6).trimmed();
+				// permissions are optional (can be empty), always in last column
+				auto permsBrowseName = listCols.last().trimmed();
 				if (!permsBrowseName.isEmpty())
 				{
 					auto permsList = this->getPermissionsList();
@@ -538,6 +568,25 @@ QQueue<QUaLog> QUaModbusClientList::setCsvClients(QString strCsvClients)
 						QUaLogCategory::Serialization
 					);
 				}
+				// get enabled (optional column, older files do not have it)
+				bool enabled = true;
+#ifndef QUA_ACCESS_CONTROL
+				if (listCols.count() > 9)
+#else
+				if (listCols.count() > 10)
+#endif // !QUA_ACCESS_CONTROL
+				{
+					enabled = (bool)listCols.at(9).trimmed().toUInt(&bOK);
+					if (!bOK)
+					{
+						enabled = true;
+						errorLogs << QUaLog(
+							tr("Invalid Enabled '%1' in row [%2]. Default value set.").arg(listCols.at(9).trimmed()).arg(strRow),
+							QUaLogLevel::Warning,
+							QUaLogCategory::Serialization
+						);
+					}
+				}
 				// check if serial client exists
 				auto clientSerial = this->browseChild<QUaModbusRtuSerialClient>(strBrowseName);
 				if (clientSerial)
@@ -591,9 +640,10 @@ QQueue<QUaLog> QUaModbusClientList::setCsvClients(QString strCsvClients)
 				clientSerial->setBaudRate(baudRate);
 				clientSerial->setDataBits(dataBits);
 				clientSerial->setStopBits(stopBits);
+				clientSerial->setEnabled(enabled);
 #ifdef QUA_ACCESS_CONTROL
-				// permissions are optional (can be empty)
-				auto permsBrowseName = listCols.at(9).trimmed();
+				// permissions are optional (can be empty), always in last column
+				auto permsBrowseName = listCols.last().trimmed();
 				if (!permsBrowseName.isEmpty())
 				{
 					auto permsList = this->getPermissionsList();
@@ -708,6 +758,44 @@ QQueue<QUaLog> QUaModbusClientList::setCsvBlocks(QString strCsvBlocks)
 				QUaLogCategory::Serialization
 			);
 		}
+		// get server address (optional column, older files do not have it)
+		int serverAddress = -1;
+#ifndef QUA_ACCESS_CONTROL
+		if (listCols.count() > 6)
+#else
+		if (listCols.count() > 7)
+#endif // !QUA_ACCESS_CONTROL
+		{
+			serverAddress = listCols.at(6).trimmed().toInt(&bOK);
+			if (!bOK)
+			{
+				serverAddress = -1;
+				errorLogs << QUaLog(
+					tr("Invalid ServerAddress '%1' in row [%2]. Default value set.").arg(listCols.at(6).trimmed()).arg(strRow),
+					QUaLogLevel::Warning,
+					QUaLogCategory::Serialization
+				);
+			}
+		}
+		// get enabled (optional column, older files do not have it)
+		bool enabled = true;
+#ifndef QUA_ACCESS_CONTROL
+		if (listCols.count() > 7)
+#else
+		if (listCols.count() > 8)
+#endif // !QUA_ACCESS_CONTROL
+		{
+			enabled = (bool)listCols.at(7).trimmed().toUInt(&bOK);
+			if (!bOK)
+			{
+				enabled = true;
+				errorLogs << QUaLog(
+					tr("Invalid Enabled '%1' in row [%2]. Default value set.").arg(listCols.at(7).trimmed()).arg(strRow),
+					QUaLogLevel::Warning,
+					QUaLogCategory::Serialization
+				);
+			}
+		}
 		// check if block exists
 		auto blocks = client->dataBlocks();
 		auto block  = blocks->browseChild<QUaModbusDataBlock>(strBrowseName);
@@ -748,9 +836,11 @@ QQueue<QUaLog> QUaModbusClientList::setCsvBlocks(QString strCsvBlocks)
 		block->setAddress(address);
 		block->setSize(size);
 		block->setSamplingTime(samplingTime);
+		block->setServerAddress(serverAddress);
+		block->setEnabled(enabled);
 #ifdef QUA_ACCESS_CONTROL
-		// permissions are optional (can be empty)
-		auto permsBrowseName = listCols.at(6).trimmed();
+		// permissions are optional (can be empty), always in last column
+		auto permsBrowseName = listCols.last().trimmed();
 		if (!permsBrowseName.isEmpty())
 		{
 			auto permsList = this->getPermissionsList();
@@ -851,6 +941,25 @@ QQueue<QUaLog> QUaModbusClientList::setCsvValues(QString strCsvValues)
 				QUaLogCategory::Serialization
 			);
 		}
+		// get enabled (optional column, older files do not have it)
+		bool enabled = true;
+#ifndef QUA_ACCESS_CONTROL
+		if (listCols.count() > 5)
+#else
+		if (listCols.count() > 6)
+#endif // !QUA_ACCESS_CONTROL
+		{
+			enabled = (bool)listCols.at(5).trimmed().toUInt(&bOK);
+			if (!bOK)
+			{
+				enabled = true;
+				errorLogs << QUaLog(
+					tr("Invalid Enabled '%1' in row [%2]. Default value set.").arg(listCols.at(5).trimmed()).arg(strRow),
+					QUaLogLevel::Warning,
+					QUaLogCategory::Serialization
+				);
+			}
+		}
 		auto values = block->values();
 		auto value  = values->browseChild<QUaModbusValue>(strBrowseName);
 		if (value)
@@ -888,9 +997,10 @@ QQueue<QUaLog> QUaModbusClientList::setCsvValues(QString strCsvValues)
 		// set properties
 		value->setType(type);
 		value->setAddressOffset(addressOffset);
+		value->setEnabled(enabled);
 #ifdef QUA_ACCESS_CONTROL
-		// permissions are optional (can be empty)
-		auto permsBrowseName = listCols.at(5).trimmed();
+		// permissions are optional (can be empty), always in last column
+		auto permsBrowseName = listCols.last().trimmed();
 		if (!permsBrowseName.isEmpty())
 		{
 			auto permsList = this->getPermissionsList();
@@ -955,6 +1065,9 @@ QDomElement QUaModbusClientList::toDomElement(QDomDocument & domDoc) const
 		elemListClients.setAttribute("Permissions", this->permissionsObject()->nodeId());
 	}
 #endif // QUA_ACCESS_CONTROL
+	// global client settings
+	elemListClients.setAttribute("MaxConcurrentConnects", QUaModbusClient::getMaxConcurrentConnects());
+	elemListClients.setAttribute("ConnectTimeout"       , QUaModbusClient::getConnectTimeout());
 	// loop children and add them as children
 	auto clients = this->browseChildren<QUaModbusClient>();
 	for (auto client : clients)
@@ -983,6 +1096,42 @@ void QUaModbusClientList::fromDomElement(QDomElement & domElem, QQueue<QUaLog>&
 		}
 	}
 #endif // QUA_ACCESS_CONTROL
+	// MaxConcurrentConnects (optional), before clients start connecting
+	if (domElem.hasAttribute("MaxConcurrentConnects"))
+	{
+		bool bOK;
+		auto maxConcurrentConnects = domElem.attribute("MaxConcurrentConnects").toInt(&bOK);
+		if (bOK)
+		{
+			QUaModbusClient::setMaxConcurrentConnects(maxConcurrentConnects);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid MaxConcurrentConnects attribute '%1' in Modbus client list. Default value set.").arg(domElem.attribute("MaxConcurrentConnects")),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// ConnectTimeout (optional)
+	if (domElem.hasAttribute("ConnectTimeout"))
+	{
+		bool bOK;
+		auto connectTimeout = domElem.attribute("ConnectTimeout").toInt(&bOK);
+		if (bOK)
+		{
+			QUaModbusClient::setConnectTimeout(connectTimeout);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid ConnectTimeout attribute '%1' in Modbus client list. Default value set.").arg(domElem.attribute("ConnectTimeout")),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
 	// add TCP clients
 	QDomNodeList listTcpClients = domElem.elementsByTagName(QUaModbusTcpClient::staticMetaObject.className());
 	for (int i = 0; i < listTcpClients.count(); i++)
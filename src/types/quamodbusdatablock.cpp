@@ -1,12 +1,20 @@
 #include "quamodbusdatablock.h"
+#include "quamodbusdatablocklist.h"
 #include "quamodbusclient.h"
 #include "quamodbusvalue.h"
 
+#include <QUaServer>
+
+#include <QtMath>
+
 #ifdef QUA_ACCESS_CONTROL
 #include <QUaPermissions>
 #endif // QUA_ACCESS_CONTROL
 
 quint32 QUaModbusDataBlock::m_minSamplingTime = 50;
+QVector<double> QUaModbusDataBlock::m_jitterBins = QVector<double>() << 0.1 << 0.5 << 1.0 << 2.0 << 5.0 << 10.0 << 20.0 << 50.0;
+// consecutive request exceptions before quarantine
+int QUaModbusDataBlock::m_quarantineAfter = 3;
 
 QUaModbusDataBlock::QUaModbusDataBlock(QUaServer *server)
 #ifndef QUA_ACCESS_CONTROL
@@ -16,12 +24,62 @@ QUaModbusDataBlock::QUaModbusDataBlock(QUaServer *server)
 #endif // !QUA_ACCESS_CONTROL
 {
 	m_loopHandle = -1;
+	m_isBursting   = false;
+	m_burstRunning = false;
+	m_lastPoll    = -1;
+	m_lastPublish = 0;
+	m_pollNominal = 1000.0;
+	m_pollCount   = 0;
+	m_pollSum     = 0.0;
+	m_pollSumSquares = 0.0;
+	m_jitterHistogram.fill(0, m_jitterBins.count() + 1);
 	m_firstSample = true;
 	m_replyRead  = nullptr;
+	m_replyCounter = nullptr;
+	m_counterType    = QModbusDataBlockType::HoldingRegisters;
+	m_counterAddress = -1;
+	m_counterValue   = -1;
+	m_counterPending = -1;
+	m_maxReadTime    = 60000;
+	m_serverAddressOverride = -1;
+	m_isBroadcast = false;
+	m_isWriteOnly = false;
+	m_isEnabled = true;
+	m_isReadWrite = false;
+	m_readbackPending = false;
+	m_isQuarantined = false;
+	m_quarantineTime = 60000;
+	m_exceptionCount = 0;
+	m_lastException = QModbusExceptionCode::NoException;
+	m_readWriteUnsupported = false;
 	m_type = nullptr;
 	m_address = nullptr;
 	m_size = nullptr;
 	m_samplingTime = nullptr;
+	m_serverAddress = nullptr;
+	m_broadcast = nullptr;
+	m_readWriteMultiple = nullptr;
+	m_readbackAfterWrite = nullptr;
+	m_quarantineInterval = nullptr;
+	m_changeCounterType = nullptr;
+	m_changeCounterAddress = nullptr;
+	m_maxReadInterval = nullptr;
+	m_triggerValue = nullptr;
+	m_triggerMode = nullptr;
+	m_readGroup = nullptr;
+	m_alignToClock = nullptr;
+	m_burstSamplingTime = nullptr;
+	m_burstDuration = nullptr;
+	m_preTriggerFrames = nullptr;
+	m_burstOnTrigger = nullptr;
+	m_pollMode = nullptr;
+	m_maxAge = nullptr;
+	m_enabled = nullptr;
+	m_burstActive = nullptr;
+	m_exceptionCode = nullptr;
+	m_quarantined = nullptr;
+	m_achievedPeriod = nullptr;
+	m_periodJitter = nullptr;
 	m_data = nullptr;
 	m_lastError = nullptr;
 	m_values = nullptr;
@@ -34,28 +92,132 @@ QUaModbusDataBlock::QUaModbusDataBlock(QUaServer *server)
 	size   ()->setValue(0);
 	samplingTime()->setDataType(QMetaType::UInt);
 	samplingTime()->setValue(1000);
+	serverAddress()->setDataType(QMetaType::Int);
+	serverAddress()->setValue(-1);
+	broadcast   ()->setValue(false);
+	readWriteMultiple()->setValue(false);
+	readbackAfterWrite()->setValue(false);
 	lastError   ()->setDataTypeEnum(QMetaEnum::fromType<QModbusError>());
 	lastError   ()->setValue(QModbusError::NoError);
+	quarantineInterval()->setDataType(QMetaType::UInt);
+	quarantineInterval()->setValue(m_quarantineTime);
+	changeCounterType   ()->setDataTypeEnum(QMetaEnum::fromType<QModbusDataBlockType>());
+	changeCounterType   ()->setValue(m_counterType);
+	changeCounterAddress()->setDataType(QMetaType::Int);
+	changeCounterAddress()->setValue(m_counterAddress);
+	maxReadInterval     ()->setDataType(QMetaType::UInt);
+	maxReadInterval     ()->setValue(m_maxReadTime);
+	triggerValue()->setValue("");
+	triggerMode ()->setDataTypeEnum(QMetaEnum::fromType<QModbusTriggerMode>());
+	triggerMode ()->setValue(QModbusTriggerMode::Change);
+	readGroup   ()->setValue("");
+	alignToClock()->setValue(false);
+	burstSamplingTime()->setDataType(QMetaType::UInt);
+	burstSamplingTime()->setValue(0);
+	burstDuration    ()->setDataType(QMetaType::UInt);
+	burstDuration    ()->setValue(2000);
+	preTriggerFrames ()->setDataType(QMetaType::UInt);
+	preTriggerFrames ()->setValue(0);
+	burstOnTrigger   ()->setValue(false);
+	pollMode()->setDataTypeEnum(QMetaEnum::fromType<QModbusPollMode>());
+	pollMode()->setValue(QModbusPollMode::Periodic);
+	maxAge  ()->setDataType(QMetaType::UInt);
+	maxAge  ()->setValue(0);
+	enabled ()->setValue(true);
+	burstActive      ()->setValue(false);
+	exceptionCode()->setDataTypeEnum(QMetaEnum::fromType<QModbusExceptionCode>());
+	exceptionCode()->setValue(QModbusExceptionCode::NoException);
+	quarantined ()->setValue(false);
+	achievedPeriod()->setDataType(QMetaType::Double);
+	achievedPeriod()->setValue(0.0);
+	periodJitter  ()->setDataType(QMetaType::Double);
+	periodJitter  ()->setValue(0.0);
 	// set initial conditions
 	type()        ->setWriteAccess(true);
 	address()     ->setWriteAccess(true);
 	size()        ->setWriteAccess(true);
 	samplingTime()->setWriteAccess(true);
+	serverAddress()->setWriteAccess(true);
+	broadcast()   ->setWriteAccess(true);
+	readWriteMultiple()->setWriteAccess(true);
+	readbackAfterWrite()->setWriteAccess(true);
+	quarantineInterval()->setWriteAccess(true);
+	changeCounterType   ()->setWriteAccess(true);
+	changeCounterAddress()->setWriteAccess(true);
+	maxReadInterval     ()->setWriteAccess(true);
+	triggerValue()->setWriteAccess(true);
+	triggerMode ()->setWriteAccess(true);
+	readGroup   ()->setWriteAccess(true);
+	alignToClock()->setWriteAccess(true);
+	burstSamplingTime()->setWriteAccess(true);
+	burstDuration    ()->setWriteAccess(true);
+	preTriggerFrames ()->setWriteAccess(true);
+	burstOnTrigger   ()->setWriteAccess(true);
+	pollMode()->setWriteAccess(true);
+	maxAge  ()->setWriteAccess(true);
+	enabled ()->setWriteAccess(true);
 	data()        ->setMinimumSamplingInterval(1000);
 	// handle state changes
 	QObject::connect(type()        , &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_typeChanged        , Qt::QueuedConnection);
 	QObject::connect(address()     , &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_addressChanged     , Qt::QueuedConnection);
 	QObject::connect(size()        , &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_sizeChanged        , Qt::QueuedConnection);
 	QObject::connect(samplingTime(), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_samplingTimeChanged, Qt::QueuedConnection);
+	QObject::connect(serverAddress(), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_serverAddressChanged, Qt::QueuedConnection);
+	QObject::connect(broadcast()   , &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_broadcastChanged   , Qt::QueuedConnection);
+	QObject::connect(readWriteMultiple(), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_readWriteMultipleChanged, Qt::QueuedConnection);
+	QObject::connect(readbackAfterWrite(), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_readbackAfterWriteChanged, Qt::QueuedConnection);
+	QObject::connect(quarantineInterval(), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_quarantineIntervalChanged, Qt::QueuedConnection);
+	QObject::connect(changeCounterType()   , &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_changeCounterTypeChanged   , Qt::QueuedConnection);
+	QObject::connect(changeCounterAddress(), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_changeCounterAddressChanged, Qt::QueuedConnection);
+	QObject::connect(maxReadInterval()     , &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_maxReadIntervalChanged     , Qt::QueuedConnection);
+	QObject::connect(triggerValue(), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_triggerValueChanged, Qt::QueuedConnection);
+	QObject::connect(triggerMode() , &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_triggerModeChanged , Qt::QueuedConnection);
+	QObject::connect(readGroup()   , &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_readGroupChanged   , Qt::QueuedConnection);
+	QObject::connect(alignToClock(), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_alignToClockChanged, Qt::QueuedConnection);
+	QObject::connect(burstSamplingTime(), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_burstSamplingTimeChanged, Qt::QueuedConnection);
+	QObject::connect(burstDuration    (), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_burstDurationChanged    , Qt::QueuedConnection);
+	QObject::connect(preTriggerFrames (), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_preTriggerFramesChanged , Qt::QueuedConnection);
+	QObject::connect(burstOnTrigger   (), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_burstOnTriggerChanged   , Qt::QueuedConnection);
+	QObject::connect(pollMode(), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_pollModeChanged, Qt::QueuedConnection);
+	QObject::connect(maxAge  (), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_maxAgeChanged  , Qt::QueuedConnection);
+	QObject::connect(enabled (), &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_enabledChanged , Qt::QueuedConnection);
+	// back to the sampling time when the burst is over
+	m_burstTimer.setSingleShot(true);
+	QObject::connect(&m_burstTimer, &QTimer::timeout, this, &QUaModbusDataBlock::on_burstTimeout);
 	QObject::connect(data()        , &QUaBaseVariable::valueChanged, this, &QUaModbusDataBlock::on_dataChanged        , Qt::QueuedConnection);
 	// to safely update error in ua server thread
 	QObject::connect(this, &QUaModbusDataBlock::updateLastError, this, &QUaModbusDataBlock::on_updateLastError);
+	QObject::connect(this, &QUaModbusDataBlock::updatePollTiming, this, &QUaModbusDataBlock::on_updatePollTiming);
 	// set descriptions
 	/*
 	type        ()->setDescription(tr("Type of Modbus register for this block."));
 	address     ()->setDescription(tr("Start register address for this block (with respect to the register type)."));
 	size        ()->setDescription(tr("Size (in registers) for this block."));
 	samplingTime()->setDescription(tr("Polling time (cycle time) to read this block."));
+	serverAddress()->setDescription(tr("Modbus server Device Id for this block (-1 to use the one of the client)."));
+	broadcast   ()->setDescription(tr("Write only block, written to all servers at once (Device Id 0) without reply. Only for RTU serial clients."));
+	readWriteMultiple()->setDescription(tr("Write holding registers with FC23 to read back the block in the same transaction."));
+	readbackAfterWrite()->setDescription(tr("Read the block right after a successful write instead of waiting for the next poll."));
+	quarantineInterval()->setDescription(tr("Time in ms between reads of a block the server keeps rejecting with an exception (0 disables quarantine)."));
+	changeCounterType   ()->setDescription(tr("Type of Modbus register of the change counter."));
+	changeCounterAddress()->setDescription(tr("Address of a register that changes whenever the block data does. Only it is polled, the block is read when it changes (-1 disables)."));
+	maxReadInterval     ()->setDescription(tr("Time in ms after which the block is read even if the change counter did not change (0 disables)."));
+	triggerValue()->setDescription(tr("Value (Block/Value) of the same client whose change reads this block once, out of cycle (empty disables)."));
+	triggerMode ()->setDescription(tr("Change of the trigger value that reads this block."));
+	readGroup   ()->setDescription(tr("Blocks with the same read group are read together, at the sampling time of the first one, and updated with the same timestamp only if all reads succeed (empty disables)."));
+	alignToClock()->setDescription(tr("Poll at wall clock multiples of the sampling time (e.g. exactly on each second) instead of whenever the block was created."));
+	burstSamplingTime()->setDescription(tr("Polling time in ms during a burst capture (0 to poll as fast as the client allows)."));
+	burstDuration    ()->setDescription(tr("Time in ms polling at burst rate after a burst capture is triggered."));
+	preTriggerFrames ()->setDescription(tr("Number of frames read before the trigger that are kept in the burst capture."));
+	burstOnTrigger   ()->setDescription(tr("The trigger value starts a burst capture instead of a single read."));
+	burstActive      ()->setDescription(tr("Whether a burst capture is in progress."));
+	pollMode()->setDescription(tr("Whether the block is read at the sampling time, only when requested, once on connection or never."));
+	maxAge  ()->setDescription(tr("Age in ms of the data under which ReadNow does not read again (0 always reads)."));
+	enabled ()->setDescription(tr("A disabled block is neither read nor written, but keeps its values and configuration."));
+	exceptionCode()->setDescription(tr("Exception code of the last response if the server rejected the request."));
+	quarantined ()->setDescription(tr("Whether the block is read at the quarantine interval instead of the sampling time."));
+	achievedPeriod()->setDescription(tr("Mean time in ms between polls over the last second."));
+	periodJitter  ()->setDescription(tr("Standard deviation in ms of the time between polls over the last second."));
 	data        ()->setDescription(tr("The current block values as per the last successfull read."));
 	lastError   ()->setDescription(tr("The last error reported while reading or writing this block."));
 	values      ()->setDescription(tr("List of converted values."));
@@ -73,6 +235,24 @@ QUaModbusDataBlock::~QUaModbusDataBlock()
 	}	
 	// make handle invalid **after** stopping loop in thread
 	m_loopHandle = -1;
+	// stop high rate loop
+	if (m_preciseLoop)
+	{
+		auto preciseLoop = m_preciseLoop;
+		preciseLoop->running = 0;
+		this->client()->m_workerThread.execInThread([preciseLoop]() {
+			delete preciseLoop->timer;
+		});
+	}
+	// stop aligned loop
+	if (m_alignedLoop)
+	{
+		auto alignedLoop = m_alignedLoop;
+		alignedLoop->running = 0;
+		this->client()->m_workerThread.execInThread([alignedLoop]() {
+			delete alignedLoop->timer;
+		});
+	}
 	// delete while block still valid, because in views values reference parent block
 	for (auto value : m_values->values())
 	{
@@ -116,6 +296,177 @@ QUaProperty * QUaModbusDataBlock::samplingTime()
 	return m_samplingTime;
 }
 
+QUaProperty * QUaModbusDataBlock::serverAddress()
+{
+	if (!m_serverAddress)
+	{
+		m_serverAddress = this->browseChild<QUaProperty>("ServerAddress");
+	}
+	return m_serverAddress;
+}
+
+QUaProperty * QUaModbusDataBlock::broadcast()
+{
+	if (!m_broadcast)
+	{
+		m_broadcast = this->browseChild<QUaProperty>("Broadcast");
+	}
+	return m_broadcast;
+}
+
+QUaProperty * QUaModbusDataBlock::readWriteMultiple()
+{
+	if (!m_readWriteMultiple)
+	{
+		m_readWriteMultiple = this->browseChild<QUaProperty>("ReadWriteMultiple");
+	}
+	return m_readWriteMultiple;
+}
+
+QUaProperty * QUaModbusDataBlock::readbackAfterWrite()
+{
+	if (!m_readbackAfterWrite)
+	{
+		m_readbackAfterWrite = this->browseChild<QUaProperty>("ReadbackAfterWrite");
+	}
+	return m_readbackAfterWrite;
+}
+
+QUaProperty * QUaModbusDataBlock::quarantineInterval()
+{
+	if (!m_quarantineInterval)
+	{
+		m_quarantineInterval = this->browseChild<QUaProperty>("QuarantineInterval");
+	}
+	return m_quarantineInterval;
+}
+
+QUaProperty * QUaModbusDataBlock::changeCounterType()
+{
+	if (!m_changeCounterType)
+	{
+		m_changeCounterType = this->browseChild<QUaProperty>("ChangeCounterType");
+	}
+	return m_changeCounterType;
+}
+
+QUaProperty * QUaModbusDataBlock::changeCounterAddress()
+{
+	if (!m_changeCounterAddress)
+	{
+		m_changeCounterAddress = this->browseChild<QUaProperty>("ChangeCounterAddress");
+	}
+	return m_changeCounterAddress;
+}
+
+QUaProperty * QUaModbusDataBlock::maxReadInterval()
+{
+	if (!m_maxReadInterval)
+	{
+		m_maxReadInterval = this->browseChild<QUaProperty>("MaxReadInterval");
+	}
+	return m_maxReadInterval;
+}
+
+QUaProperty * QUaModbusDataBlock::triggerValue()
+{
+	if (!m_triggerValue)
+	{
+		m_triggerValue = this->browseChild<QUaProperty>("TriggerValue");
+	}
+	return m_triggerValue;
+}
+
+QUaProperty * QUaModbusDataBlock::triggerMode()
+{
+	if (!m_triggerMode)
+	{
+		m_triggerMode = this->browseChild<QUaProperty>("TriggerMode");
+	}
+	return m_triggerMode;
+}
+
+QUaProperty * QUaModbusDataBlock::readGroup()
+{
+	if (!m_readGroup)
+	{
+		m_readGroup = this->browseChild<QUaProperty>("ReadGroup");
+	}
+	return m_readGroup;
+}
+
+QUaProperty * QUaModbusDataBlock::alignToClock()
+{
+	if (!m_alignToClock)
+	{
+		m_alignToClock = this->browseChild<QUaProperty>("AlignToClock");
+	}
+	return m_alignToClock;
+}
+
+QUaProperty * QUaModbusDataBlock::burstSamplingTime()
+{
+	if (!m_burstSamplingTime)
+	{
+		m_burstSamplingTime = this->browseChild<QUaProperty>("BurstSamplingTime");
+	}
+	return m_burstSamplingTime;
+}
+
+QUaProperty * QUaModbusDataBlock::burstDuration()
+{
+	if (!m_burstDuration)
+	{
+		m_burstDuration = this->browseChild<QUaProperty>("BurstDuration");
+	}
+	return m_burstDuration;
+}
+
+QUaProperty * QUaModbusDataBlock::preTriggerFrames()
+{
+	if (!m_preTriggerFrames)
+	{
+		m_preTriggerFrames = this->browseChild<QUaProperty>("PreTriggerFrames");
+	}
+	return m_preTriggerFrames;
+}
+
+QUaProperty * QUaModbusDataBlock::burstOnTrigger()
+{
+	if (!m_burstOnTrigger)
+	{
+		m_burstOnTrigger = this->browseChild<QUaProperty>("BurstOnTrigger");
+	}
+	return m_burstOnTrigger;
+}
+
+QUaProperty * QUaModbusDataBlock::pollMode()
+{
+	if (!m_pollMode)
+	{
+		m_pollMode = this->browseChild<QUaProperty>("PollMode");
+	}
+	return m_pollMode;
+}
+
+QUaProperty * QUaModbusDataBlock::maxAge()
+{
+	if (!m_maxAge)
+	{
+		m_maxAge = this->browseChild<QUaProperty>("MaxAge");
+	}
+	return m_maxAge;
+}
+
+QUaProperty * QUaModbusDataBlock::enabled()
+{
+	if (!m_enabled)
+	{
+		m_enabled = this->browseChild<QUaProperty>("Enabled");
+	}
+	return m_enabled;
+}
+
 QUaBaseDataVariable * QUaModbusDataBlock::data()
 {
 	if (!m_data)
@@ -134,6 +485,51 @@ QUaBaseDataVariable * QUaModbusDataBlock::lastError()
 	return m_lastError;
 }
 
+QUaBaseDataVariable * QUaModbusDataBlock::exceptionCode()
+{
+	if (!m_exceptionCode)
+	{
+		m_exceptionCode = this->browseChild<QUaBaseDataVariable>("ExceptionCode");
+	}
+	return m_exceptionCode;
+}
+
+QUaBaseDataVariable * QUaModbusDataBlock::quarantined()
+{
+	if (!m_quarantined)
+	{
+		m_quarantined = this->browseChild<QUaBaseDataVariable>("Quarantined");
+	}
+	return m_quarantined;
+}
+
+QUaBaseDataVariable * QUaModbusDataBlock::achievedPeriod()
+{
+	if (!m_achievedPeriod)
+	{
+		m_achievedPeriod = this->browseChild<QUaBaseDataVariable>("AchievedPeriod");
+	}
+	return m_achievedPeriod;
+}
+
+QUaBaseDataVariable * QUaModbusDataBlock::periodJitter()
+{
+	if (!m_periodJitter)
+	{
+		m_periodJitter = this->browseChild<QUaBaseDataVariable>("PeriodJitter");
+	}
+	return m_periodJitter;
+}
+
+QUaBaseDataVariable * QUaModbusDataBlock::burstActive()
+{
+	if (!m_burstActive)
+	{
+		m_burstActive = this->browseChild<QUaBaseDataVariable>("BurstActive");
+	}
+	return m_burstActive;
+}
+
 QUaModbusValueList * QUaModbusDataBlock::values()
 {
 	if (!m_values)
@@ -146,9 +542,8 @@ QUaModbusValueList * QUaModbusDataBlock::values()
 void QUaModbusDataBlock::remove()
 {
 	// stop loop
-	this->client()->m_workerThread.stopLoopInThread(m_loopHandle);
-	// make handle invalid **after** stopping loop in thread
-	m_loopHandle = -1;
+	m_burstTimer.stop();
+	this->stopLoop();
 	// call deleteLater in thread, so thread has time to stop loop first
 	// NOTE : deleteLater will delete the object in the correct thread anyways
 	this->client()->m_workerThread.execInThread([this]() {
@@ -157,6 +552,121 @@ void QUaModbusDataBlock::remove()
 	}, Qt::EventPriority::LowEventPriority);
 }
 
+QString QUaModbusDataBlock::pollTiming()
+{
+	QString strCsv = tr("Deviation,Polls\n");
+	QMutexLocker locker(&m_timingMutex);
+	for (int bin = 0; bin < m_jitterHistogram.count(); bin++)
+	{
+		strCsv += QString("%1%2,%3\n")
+			.arg(bin < m_jitterBins.count() ? "<" : ">=")
+			.arg(m_jitterBins.at(qMin(bin, m_jitterBins.count() - 1)))
+			.arg(m_jitterHistogram.at(bin));
+	}
+	return strCsv;
+}
+
+void QUaModbusDataBlock::resetPollTiming()
+{
+	// reset in thread for safety
+	this->client()->m_workerThread.execInThread([this]() {
+		this->resetPollStats();
+	});
+}
+
+void QUaModbusDataBlock::readNow()
+{
+	// disabled blocks are never read
+	if (!this->getEnabled())
+	{
+		emit this->readFinished(QModbusError::ConfigurationError);
+		return;
+	}
+	// cached data is recent enough
+	auto maxAge = this->getMaxAge();
+	if (maxAge > 0 && m_lastUpdate.isValid() && m_lastUpdate.elapsed() < maxAge)
+	{
+		emit this->readFinished(this->getLastError());
+		return;
+	}
+	// nothing to wait for
+	if (!this->isWellConfigured() || this->getBroadcast() || this->getPollMode() == QModbusPollMode::WriteOnly)
+	{
+		emit this->readFinished(QModbusError::ConfigurationError);
+		return;
+	}
+	auto client = this->client();
+	if (client->getState() != QModbusState::ConnectedState)
+	{
+		emit this->readFinished(client->getLastError());
+		return;
+	}
+	this->readback();
+}
+
+void QUaModbusDataBlock::captureBurst()
+{
+	// one capture at a time, write only and disabled blocks are never read
+	if (m_burstRunning || this->getPollMode() == QModbusPollMode::WriteOnly || !this->getEnabled())
+	{
+		return;
+	}
+	m_burstRunning = true;
+	m_burstTrigger = QDateTime::currentDateTimeUtc();
+	// frames before the trigger go first
+	m_burstFrames  = m_preTrigger;
+	m_preTrigger.clear();
+	this->burstActive()->setValue(true);
+	// read the whole block every time, even if grouped or gated by a change counter
+	this->client()->m_workerThread.execInThread([this]() {
+		m_isBursting = true;
+	});
+	// restart loop at burst rate
+	this->stopLoop();
+	this->startLoop();
+	m_burstTimer.start(static_cast<int>(this->getBurstDuration()));
+}
+
+QString QUaModbusDataBlock::burstCapture()
+{
+	QString strCsv = tr("Timestamp,Offset");
+	auto address = this->getAddress();
+	for (quint32 i = 0; i < this->getSize(); i++)
+	{
+		strCsv += QString(",%1").arg(address + static_cast<int>(i));
+	}
+	strCsv += "\n";
+	for (auto frame : m_burstFrames)
+	{
+		strCsv += QString("%1,%2")
+			.arg(frame.timestamp.toString(Qt::ISODateWithMs))
+			.arg(m_burstTrigger.msecsTo(frame.timestamp));
+		for (auto reg : frame.data)
+		{
+			strCsv += QString(",%1").arg(reg);
+		}
+		strCsv += "\n";
+	}
+	return strCsv;
+}
+
+void QUaModbusDataBlock::liftQuarantine()
+{
+	m_exceptionCount = 0;
+	m_lastException  = QModbusExceptionCode::NoException;
+	if (!this->isQuarantined())
+	{
+		return;
+	}
+	// set in thread for safety
+	this->client()->m_workerThread.execInThread([this]() {
+		m_isQuarantined = false;
+	});
+	this->quarantined()->setValue(false);
+	// emit
+	emit this->quarantinedChanged(false);
+}
+
 void QUaModbusDataBlock::on_typeChanged(const QVariant &value, const bool& networkChange)
 {
 	if (!networkChange)
@@ -168,6 +678,8 @@ void QUaModbusDataBlock::on_typeChanged(const QVariant &value, const bool& netwo
 	this->client()->m_workerThread.execInThread([this, type]() {
 		m_registerType = static_cast<QModbusDataBlockType>(type);
 	});
+	// the server might accept the new request
+	this->liftQuarantine();
 	// set data writable according to type
 	if (type == QModbusDataBlockType::Coils ||
 		type == QModbusDataBlockType::HoldingRegisters)
@@ -207,6 +719,8 @@ void QUaModbusDataBlock::on_addressChanged(const QVariant & value, const bool& n
 	this->client()->m_workerThread.execInThread([this, address]() {
 		m_startAddress = address;
 	});
+	// the server might accept the new request
+	this->liftQuarantine();
 	// emit
 	emit this->addressChanged(address);
 }
@@ -222,6 +736,8 @@ void QUaModbusDataBlock::on_sizeChanged(const QVariant & value, const bool& netw
 	this->client()->m_workerThread.execInThread([this, size]() {
 		m_valueCount = size;
 	});
+	// the server might accept the new request
+	this->liftQuarantine();
 	// emit
 	emit this->sizeChanged(size);
 }
@@ -232,22 +748,22 @@ void QUaModbusDataBlock::on_samplingTimeChanged(const QVariant & value, const bo
 	{
 		return;
 	}
-	// check minimum sampling time
-	auto samplingTime = value.value<quint32>();
+	// check minimum sampling time, can be lowered per client for fast devices
+	auto samplingTime    = value.value<quint32>();
+	auto client          = this->client();
+	auto minSamplingTime = client ? client->getMinSamplingTime() : QUaModbusDataBlock::m_minSamplingTime;
 	// do not allow less than minimum
-	if (samplingTime < QUaModbusDataBlock::m_minSamplingTime)
+	if (samplingTime < minSamplingTime)
 	{
 		// set minumum
-		this->samplingTime()->setValue(QUaModbusDataBlock::m_minSamplingTime);
+		this->samplingTime()->setValue(minSamplingTime);
 		// the previous will trigger the event again
 		// emit
-		emit this->samplingTimeChanged(QUaModbusDataBlock::m_minSamplingTime);
+		emit this->samplingTimeChanged(minSamplingTime);
 		return;
 	}
 	// stop old loop
-	this->client()->m_workerThread.stopLoopInThread(m_loopHandle);
-	// make handle invalid **after** stopping loop in thread
-	m_loopHandle = -1;
+	this->stopLoop();
 	// start new loop
 	this->startLoop();
 	// update ua sample interval for data
@@ -256,117 +772,711 @@ void QUaModbusDataBlock::on_samplingTimeChanged(const QVariant & value, const bo
 	emit this->samplingTimeChanged(samplingTime);
 }
 
-void QUaModbusDataBlock::on_dataChanged(const QVariant & value, const bool& networkChange)
+void QUaModbusDataBlock::on_serverAddressChanged(const QVariant & value, const bool & networkChange)
 {
 	if (!networkChange)
 	{
 		return;
 	}
-	// convert data
-	QVector<quint16> data = QUaModbusDataBlock::variantToInt16Vect(value);
+	auto serverAddress = value.value<int>();
+	// only allow valid device ids or -1 (use the one of the client)
+	if (serverAddress < -1 || serverAddress > 255)
+	{
+		serverAddress = -1;
+		this->serverAddress()->setValue(serverAddress);
+	}
+	// set in thread for safety
+	this->client()->m_workerThread.execInThread([this, serverAddress]() {
+		m_serverAddressOverride = serverAddress;
+	});
 	// emit
-	emit this->dataChanged(data);
-	// write to modbus
-	this->setModbusData(data);
+	emit this->serverAddressChanged(serverAddress);
 }
 
-void QUaModbusDataBlock::on_updateLastError(const QModbusError & error)
+void QUaModbusDataBlock::on_broadcastChanged(const QVariant & value, const bool & networkChange)
 {
-	// avoid update or emit if no change, improves performance
-	if (error == this->getLastError())
+	if (!networkChange)
 	{
 		return;
 	}
-	this->lastError()->setValue(error);
-	// NOTE : need to add custom signal because OPC UA valueChanged
-	//        only works for changes through network
+	auto broadcast = value.toBool();
+	// device id 0 is not broadcast on modbus tcp, just another unit id of the gateway
+	if (broadcast && !this->canBroadcast())
+	{
+		this->broadcast()->setValue(false);
+		// emit
+		emit this->broadcastChanged(false);
+		return;
+	}
+	// set in thread for safety
+	this->client()->m_workerThread.execInThread([this, broadcast]() {
+		m_isBroadcast = broadcast;
+	});
 	// emit
-	emit this->lastErrorChanged(error);
-	// update errors in values
-	auto values = this->values()->values();
-	for (auto value : values)
+	emit this->broadcastChanged(broadcast);
+}
+
+void QUaModbusDataBlock::on_readWriteMultipleChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
 	{
-		// need to keep configuration error if value is still not well configured
-		auto isWellConfigured = value->isWellConfigured();
-		if (!isWellConfigured)
-		{
-			continue;
-		}
-		value->setLastError(error);
+		return;
 	}
+	auto readWriteMultiple = value.toBool();
+	// set in thread for safety, give the server another chance
+	this->client()->m_workerThread.execInThread([this, readWriteMultiple]() {
+		m_isReadWrite = readWriteMultiple;
+		m_readWriteUnsupported = false;
+	});
+	// emit
+	emit this->readWriteMultipleChanged(readWriteMultiple);
 }
 
-QUaModbusDataBlockList * QUaModbusDataBlock::list() const
+void QUaModbusDataBlock::on_readbackAfterWriteChanged(const QVariant & value, const bool & networkChange)
 {
-	return qobject_cast<QUaModbusDataBlockList*>(this->parent());
+	if (!networkChange)
+	{
+		return;
+	}
+	// emit
+	emit this->readbackAfterWriteChanged(value.toBool());
 }
 
-QUaModbusClient * QUaModbusDataBlock::client() const
+void QUaModbusDataBlock::on_quarantineIntervalChanged(const QVariant & value, const bool & networkChange)
 {
-	return this->list()->client();
+	if (!networkChange)
+	{
+		return;
+	}
+	auto quarantineInterval = value.value<quint32>();
+	// set in thread for safety
+	this->client()->m_workerThread.execInThread([this, quarantineInterval]() {
+		m_quarantineTime = quarantineInterval;
+	});
+	// quarantine disabled
+	if (quarantineInterval == 0)
+	{
+		this->liftQuarantine();
+	}
+	// emit
+	emit this->quarantineIntervalChanged(quarantineInterval);
 }
 
-void QUaModbusDataBlock::startLoop()
+void QUaModbusDataBlock::on_changeCounterTypeChanged(const QVariant & value, const bool & networkChange)
 {
-	auto samplingTime = this->samplingTime()->value().value<quint32>();
-	// exec read request in client thread
-	m_loopHandle = this->client()->m_workerThread.startLoopInThread(
-	[this]() {
-		//Q_ASSERT(m_loopHandle > 0); // NOTE : this does happen when cleaning all blocks form a client
-		if (m_loopHandle <= 0)
-		{
-			return;
-		}
-		auto client = this->client();
-		// TODO : can happen in shutdown? possible BUG
-		if (!client)
-		{
-			return;
-		}
-		// check if ongoing request
-		if (m_replyRead)
+	if (!networkChange)
+	{
+		return;
+	}
+	auto changeCounterType = value.value<QModbusDataBlockType>();
+	// set in thread for safety, forget last counter so the block is read
+	this->client()->m_workerThread.execInThread([this, changeCounterType]() {
+		m_counterType    = changeCounterType;
+		m_counterValue   = -1;
+		m_counterPending = -1;
+	});
+	// emit
+	emit this->changeCounterTypeChanged(changeCounterType);
+}
+
+void QUaModbusDataBlock::on_changeCounterAddressChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto changeCounterAddress = value.value<int>();
+	// set in thread for safety, forget last counter so the block is read
+	this->client()->m_workerThread.execInThread([this, changeCounterAddress]() {
+		m_counterAddress = changeCounterAddress;
+		m_counterValue   = -1;
+		m_counterPending = -1;
+	});
+	// emit
+	emit this->changeCounterAddressChanged(changeCounterAddress);
+}
+
+void QUaModbusDataBlock::on_maxReadIntervalChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto maxReadInterval = value.value<quint32>();
+	// set in thread for safety
+	this->client()->m_workerThread.execInThread([this, maxReadInterval]() {
+		m_maxReadTime = maxReadInterval;
+	});
+	// emit
+	emit this->maxReadIntervalChanged(maxReadInterval);
+}
+
+void QUaModbusDataBlock::on_triggerValueChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto strTriggerValue = value.toString();
+	// NOTE : value might not exist yet (e.g. loading a configuration), try again once everything is loaded
+	//        after that it is resolved again whenever blocks or values are added or renamed
+	if (!this->resolveTrigger())
+	{
+		QTimer::singleShot(0, this, [this]() {
+			if (!this->resolveTrigger())
+			{
+				this->logUnresolvedTrigger();
+			}
+		});
+	}
+	// emit
+	emit this->triggerValueChanged(strTriggerValue);
+}
+
+void QUaModbusDataBlock::on_triggerModeChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	// emit
+	emit this->triggerModeChanged(value.value<QModbusTriggerMode>());
+}
+
+void QUaModbusDataBlock::on_readGroupChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto strReadGroup = value.toString();
+	// set in thread for safety
+	this->client()->m_workerThread.execInThread([this, strReadGroup]() {
+		this->list()->setGroupMember(this, m_groupName, strReadGroup);
+		m_groupName = strReadGroup;
+	});
+	// emit
+	emit this->readGroupChanged(strReadGroup);
+}
+
+void QUaModbusDataBlock::on_alignToClockChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	// restart loop in the new mode
+	this->stopLoop();
+	this->startLoop();
+	// emit
+	emit this->alignToClockChanged(value.toBool());
+}
+
+void QUaModbusDataBlock::on_burstSamplingTimeChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	// NOTE : applies to the next burst
+	emit this->burstSamplingTimeChanged(value.value<quint32>());
+}
+
+void QUaModbusDataBlock::on_burstDurationChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	// NOTE : applies to the next burst
+	emit this->burstDurationChanged(value.value<quint32>());
+}
+
+void QUaModbusDataBlock::on_preTriggerFramesChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto preTriggerFrames = value.value<quint32>();
+	while (static_cast<quint32>(m_preTrigger.count()) > preTriggerFrames)
+	{
+		m_preTrigger.removeFirst();
+	}
+	// emit
+	emit this->preTriggerFramesChanged(preTriggerFrames);
+}
+
+void QUaModbusDataBlock::on_burstOnTriggerChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	// emit
+	emit this->burstOnTriggerChanged(value.toBool());
+}
+
+void QUaModbusDataBlock::on_pollModeChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto pollMode = value.value<QModbusPollMode>();
+	// set in thread for safety
+	this->client()->m_workerThread.execInThread([this, pollMode]() {
+		m_isWriteOnly = pollMode == QModbusPollMode::WriteOnly;
+	});
+	// read once each time the client connects
+	QObject::disconnect(m_connectConnection);
+	if (pollMode == QModbusPollMode::OnConnect)
+	{
+		auto client = this->client();
+		m_connectConnection = QObject::connect(client, &QUaModbusClient::stateChanged, this,
+		[this](const QModbusState &state) {
+			if (state != QModbusState::ConnectedState)
+			{
+				return;
+			}
+			this->readback();
+		});
+		if (client->getState() == QModbusState::ConnectedState)
 		{
-			return;
+			this->readback();
 		}
-		// check if request is valid
-		if (m_registerType == QModbusDataBlockType::Invalid)
+	}
+	// restart loop in the new mode, only periodic blocks have one
+	this->stopLoop();
+	this->startLoop();
+	// emit
+	emit this->pollModeChanged(pollMode);
+}
+
+void QUaModbusDataBlock::on_maxAgeChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	// emit
+	emit this->maxAgeChanged(value.value<quint32>());
+}
+
+void QUaModbusDataBlock::on_enabledChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto enabled = value.toBool();
+	// set in thread for safety
+	this->client()->m_workerThread.execInThread([this, enabled]() {
+		m_isEnabled = enabled;
+	});
+	// stop polling, or resume it right away
+	this->stopLoop();
+	this->startLoop();
+	// emit
+	emit this->enabledChanged(enabled);
+}
+
+void QUaModbusDataBlock::on_burstTimeout()
+{
+	m_burstRunning = false;
+	this->client()->m_workerThread.execInThread([this]() {
+		m_isBursting = false;
+	});
+	this->burstActive()->setValue(false);
+	// back to the sampling time
+	this->stopLoop();
+	this->startLoop();
+	// emit
+	emit this->burstCaptured();
+}
+
+void QUaModbusDataBlock::on_triggerUpdated(const QVariant & value)
+{
+	auto last = m_triggerLast;
+	m_triggerLast = value;
+	// no reference to compare against (first sample or error)
+	if (!last.isValid() || !value.isValid() || last == value)
+	{
+		return;
+	}
+	bool wasSet = last.toDouble()  != 0.0;
+	bool isSet  = value.toDouble() != 0.0;
+	switch (this->getTriggerMode())
+	{
+	case QModbusTriggerMode::Rising:
+		if (wasSet || !isSet)
 		{
-			emit this->updateLastError(QModbusError::ConfigurationError);
 			return;
 		}
-		if (m_startAddress < 0)
+		break;
+	case QModbusTriggerMode::Falling:
+		if (!wasSet || isSet)
 		{
-			emit this->updateLastError(QModbusError::ConfigurationError);
 			return;
 		}
-		if (m_valueCount == 0)
+		break;
+	default:
+		break;
+	}
+	if (this->getBurstOnTrigger())
+	{
+		this->captureBurst();
+		return;
+	}
+	this->readback();
+}
+
+void QUaModbusDataBlock::on_dataChanged(const QVariant & value, const bool& networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	// convert data
+	QVector<quint16> data = QUaModbusDataBlock::variantToInt16Vect(value);
+	// emit
+	emit this->dataChanged(data);
+	// write to modbus
+	this->setModbusData(data);
+}
+
+void QUaModbusDataBlock::on_updatePollTiming(const double & period, const double & jitter)
+{
+	this->achievedPeriod()->setValue(period);
+	this->periodJitter  ()->setValue(jitter);
+}
+
+void QUaModbusDataBlock::on_updateLastError(const QModbusError & error)
+{
+	// avoid update or emit if no change, improves performance
+	if (error == this->getLastError())
+	{
+		return;
+	}
+	this->lastError()->setValue(error);
+	// NOTE : need to add custom signal because OPC UA valueChanged
+	//        only works for changes through network
+	// emit
+	emit this->lastErrorChanged(error);
+	// update errors in values
+	auto values = this->values()->values();
+	for (auto value : values)
+	{
+		// need to keep configuration error if value is still not well configured
+		auto isWellConfigured = value->isWellConfigured();
+		if (!isWellConfigured)
+		{
+			continue;
+		}
+		value->setLastError(error);
+	}
+}
+
+QUaModbusDataBlockList * QUaModbusDataBlock::list() const
+{
+	return qobject_cast<QUaModbusDataBlockList*>(this->parent());
+}
+
+QUaModbusClient * QUaModbusDataBlock::client() const
+{
+	return this->list()->client();
+}
+
+void QUaModbusDataBlock::startLoop()
+{
+	// no loop while the block or its client are disabled
+	if (!this->getEnabled() || !this->client()->getEnabled())
+	{
+		return;
+	}
+	auto samplingTime = m_burstRunning ?
+		qMax(this->getBurstSamplingTime(), this->client()->getMinSamplingTime()) :
+		this->samplingTime()->value().value<quint32>();
+	// measure against the new sampling time
+	this->client()->m_workerThread.execInThread([this, samplingTime]() {
+		m_pollNominal = static_cast<double>(samplingTime);
+		this->resetPollStats();
+	});
+	// no loop, only read when requested
+	if (this->getPollMode() != QModbusPollMode::Periodic && !m_burstRunning)
+	{
+		return;
+	}
+	// poll on wall clock boundaries instead of a free running loop
+	if (this->getAlignToClock() && !m_burstRunning)
+	{
+		auto alignedLoop = QSharedPointer<QUaModbusAlignedLoop>::create();
+		alignedLoop->period = qMax(samplingTime, 1u);
+		m_alignedLoop = alignedLoop;
+		// NOTE : timer created in thread so it fires in thread, away from ua server jitter
+		this->client()->m_workerThread.execInThread([this, alignedLoop]() {
+			auto loop = alignedLoop.data();
+			loop->timer = new QTimer;
+			loop->timer->setTimerType(Qt::PreciseTimer);
+			loop->timer->setSingleShot(true);
+			QObject::connect(loop->timer, &QTimer::timeout, loop->timer, [this, loop]() {
+				if (!loop->running)
+				{
+					return;
+				}
+				this->poll();
+				this->scheduleAlignedPoll(loop);
+			});
+			this->scheduleAlignedPoll(loop);
+		});
+		return;
+	}
+	// high rate, the loop timer is too coarse for it
+	if (samplingTime < QUaModbusDataBlock::m_minSamplingTime)
+	{
+		auto preciseLoop = QSharedPointer<QUaModbusPreciseLoop>::create();
+		m_preciseLoop = preciseLoop;
+		// NOTE : timer created in thread so it fires in thread
+		this->client()->m_workerThread.execInThread([this, preciseLoop, samplingTime]() {
+			auto loop = preciseLoop.data();
+			loop->timer = new QTimer;
+			loop->timer->setTimerType(Qt::PreciseTimer);
+			QObject::connect(loop->timer, &QTimer::timeout, loop->timer, [this, loop]() {
+				if (!loop->running)
+				{
+					return;
+				}
+				this->poll();
+			});
+			loop->timer->start(static_cast<int>(samplingTime));
+		});
+		return;
+	}
+	// exec read request in client thread
+	m_loopHandle = this->client()->m_workerThread.startLoopInThread(
+	[this]() {
+		//Q_ASSERT(m_loopHandle > 0); // NOTE : this does happen when cleaning all blocks form a client
+		if (m_loopHandle <= 0)
 		{
-			emit this->updateLastError(QModbusError::ConfigurationError);
 			return;
 		}
-		// check if connected
-		auto state = client->getState();
-		if (state != QModbusState::ConnectedState)
+		this->poll();
+		}, samplingTime);
+	Q_ASSERT(m_loopHandle > 0);
+}
+
+void QUaModbusDataBlock::stopLoop()
+{
+	if (m_loopHandle > 0)
+	{
+		this->client()->m_workerThread.stopLoopInThread(m_loopHandle);
+	}
+	// make handle invalid **after** stopping loop in thread
+	m_loopHandle = -1;
+	// stop polling right away, delete timer in its thread
+	if (m_preciseLoop)
+	{
+		auto preciseLoop = m_preciseLoop;
+		preciseLoop->running = 0;
+		this->client()->m_workerThread.execInThread([preciseLoop]() {
+			delete preciseLoop->timer;
+		});
+		m_preciseLoop.reset();
+	}
+	if (m_alignedLoop)
+	{
+		auto alignedLoop = m_alignedLoop;
+		alignedLoop->running = 0;
+		this->client()->m_workerThread.execInThread([alignedLoop]() {
+			delete alignedLoop->timer;
+		});
+		m_alignedLoop.reset();
+	}
+}
+
+void QUaModbusDataBlock::scheduleAlignedPoll(QUaModbusAlignedLoop * loop)
+{
+	auto now = QDateTime::currentMSecsSinceEpoch();
+	// next boundary is computed from the wall clock every time, so errors do not accumulate
+	// NOTE : timers might fire a bit early, never poll twice for the same boundary
+	loop->next = (qMax(now, loop->next) / loop->period + 1) * loop->period;
+	loop->timer->start(static_cast<int>(loop->next - now));
+}
+
+void QUaModbusDataBlock::measurePollTiming()
+{
+	if (!m_pollClock.isValid())
+	{
+		m_pollClock.start();
+	}
+	auto now = m_pollClock.nsecsElapsed();
+	if (m_lastPoll < 0)
+	{
+		m_lastPoll    = now;
+		m_lastPublish = now;
+		return;
+	}
+	double period = static_cast<double>(now - m_lastPoll) / 1000000.0;
+	m_lastPoll = now;
+	// histogram of the deviation from the sampling time
+	auto deviation = qAbs(period - m_pollNominal);
+	int bin = 0;
+	while (bin < m_jitterBins.count() && deviation >= m_jitterBins.at(bin))
+	{
+		bin++;
+	}
+	m_timingMutex.lock();
+	m_jitterHistogram[bin]++;
+	m_timingMutex.unlock();
+	m_pollCount++;
+	m_pollSum        += period;
+	m_pollSumSquares += period * period;
+	// publish at most once per second, high rate blocks would flood the ua server thread
+	if (now - m_lastPublish < 1000000000LL)
+	{
+		return;
+	}
+	double mean   = m_pollSum / m_pollCount;
+	double jitter = qSqrt(qMax(0.0, m_pollSumSquares / m_pollCount - mean * mean));
+	emit this->updatePollTiming(mean, jitter);
+	m_pollCount      = 0;
+	m_pollSum        = 0.0;
+	m_pollSumSquares = 0.0;
+	m_lastPublish    = now;
+}
+
+void QUaModbusDataBlock::resetPollStats()
+{
+	m_lastPoll       = -1;
+	m_pollCount      = 0;
+	m_pollSum        = 0.0;
+	m_pollSumSquares = 0.0;
+	QMutexLocker locker(&m_timingMutex);
+	m_jitterHistogram.fill(0);
+}
+
+void QUaModbusDataBlock::poll()
+{
+	// measure achieved period, also when not actually reading
+	this->measurePollTiming();
+	auto client = this->client();
+	// TODO : can happen in shutdown? possible BUG
+	if (!client)
+	{
+		return;
+	}
+	// check if ongoing request or disabled in the meantime
+	if (m_replyRead || m_replyCounter || !m_isEnabled)
+	{
+		return;
+	}
+	// check if request is valid
+	if (m_registerType == QModbusDataBlockType::Invalid)
+	{
+		emit this->updateLastError(QModbusError::ConfigurationError);
+		return;
+	}
+	if (m_startAddress < 0)
+	{
+		emit this->updateLastError(QModbusError::ConfigurationError);
+		return;
+	}
+	if (m_valueCount == 0)
+	{
+		emit this->updateLastError(QModbusError::ConfigurationError);
+		return;
+	}
+	// nothing to read, broadcast blocks are write only
+	if (m_isBroadcast)
+	{
+		return;
+	}
+	// check if connected
+	auto state = client->getState();
+	if (state != QModbusState::ConnectedState)
+	{
+		if (!m_firstSample)
 		{
-			if (!m_firstSample)
+			// force update last modbus value
+			auto values = this->values()->values();
+			for (auto value : values)
 			{
-				// force update last modbus value
-				auto values = this->values()->values();
-				for (auto value : values)
-				{
-					emit value->valueChanged(value->getValue());
-				}
-				m_firstSample = true;
+				emit value->valueChanged(value->getValue());
 			}
-			auto clientError = client->getLastError();
-			emit this->updateLastError(clientError);
+			m_firstSample = true;
+		}
+		// counter might have moved while disconnected
+		m_counterValue   = -1;
+		m_counterPending = -1;
+		auto clientError = client->getLastError();
+		emit this->updateLastError(clientError);
+		return;
+	}
+	// quarantined blocks are only read once per quarantine interval
+	if (m_isQuarantined)
+	{
+		if (m_quarantineProbe.elapsed() < m_quarantineTime)
+		{
 			return;
 		}
-		// create and send request		
-		auto serverAddress = client->getServerAddress();
+		m_quarantineProbe.start();
+	}
+	// every frame is needed during a burst capture
+	if (m_isBursting)
+	{
+		this->enqueueRead();
+		return;
+	}
+	// the whole group is read together, driven by a single member
+	// NOTE : quarantined members are left out of the group and read on their own
+	if (!m_groupName.isEmpty() && !m_isQuarantined)
+	{
+		auto list = this->list();
+		if (list->groupLeader(m_groupName) == this)
+		{
+			list->readGroup(m_groupName);
+		}
+		return;
+	}
+	// only poll the change counter, unless it is time to read anyway
+	if (m_counterAddress >= 0 &&
+		(m_maxReadTime == 0 || !m_lastRead.isValid() || m_lastRead.elapsed() < m_maxReadTime))
+	{
+		this->enqueueCounterRead();
+		return;
+	}
+	// read in scheduler, so the bus is shared fairly with other blocks
+	this->enqueueRead();
+}
+
+void QUaModbusDataBlock::enqueueRead(const QSharedPointer<QUaModbusGroupRead> &groupRead/* = nullptr*/, const int &index/* = -1*/)
+{
+	auto client = this->client();
+	auto serverAddress = this->requestServerAddress();
+	bool queued = client->m_scheduler->enqueue(serverAddress, this, groupRead ? QUaModbusScheduler::GroupRead : QUaModbusScheduler::Read,
+	[this, client, serverAddress, groupRead, index]() -> QModbusReply* {
+		// a single read and a group read of this block must not be in flight at once
+		if (m_replyRead)
+		{
+			if (groupRead)
+			{
+				QTimer::singleShot(0, this, [this, groupRead, index]() {
+					this->abortRead(groupRead, index, QModbusError::ReplyAbortedError);
+				});
+			}
+			else
+			{
+				// the read in flight reports to whoever waits, read again when it is done
+				m_readbackPending = true;
+			}
+			return nullptr;
+		}
+		// counter value this read is known to be newer than
+		auto counterPending = m_counterPending;
 		// NOTE : need to pass in a fresh QModbusDataUnit instance or reply for coils returns empty
 		//        wierdly, registers work fine when passing m_modbusDataUnit
-		m_replyRead = client->m_modbusClient->sendReadRequest(
+		// NOTE : handler keeps its own reply, m_replyRead only tells a read is in flight
+		QPointer<QModbusReply> p_reply = client->m_modbusClient->sendReadRequest(
 			QModbusDataUnit(
 				static_cast<QModbusDataUnit::RegisterType>(m_registerType),
 				m_startAddress, 
@@ -375,69 +1485,549 @@ void QUaModbusDataBlock::startLoop()
 			, serverAddress
 		);
 		// check if no error
-		if (!m_replyRead)
+		if (!p_reply)
+		{
+			if (!client->m_disconnectRequested)
+			{
+				emit this->updateLastError(QModbusError::ReplyAbortedError);
+			}
+			QTimer::singleShot(0, this, [this, groupRead, index]() {
+				this->abortRead(groupRead, index, QModbusError::ReplyAbortedError);
+			});
+			return nullptr;
+		}
+		m_lastRead.start();
+		// check if finished immediately (ignore)
+		if (p_reply->isFinished())
+		{
+			// broadcast replies return immediately, a read can only have failed
+			auto error = p_reply->error() != QModbusError::NoError ?
+				p_reply->error() : QModbusError::ReplyAbortedError;
+			p_reply->deleteLater();
+			QTimer::singleShot(0, this, [this, groupRead, index, error]() {
+				this->abortRead(groupRead, index, error);
+			});
+			return nullptr;
+		}
+		m_replyRead = p_reply;
+		auto timestamp = QUaModbusDataBlock::replyTimestamp(p_reply);
+		// subscribe to finished
+		QObject::connect(p_reply.data(), &QModbusReply::finished, this,
+			[this, p_reply, groupRead, index, counterPending, timestamp]() {
+				// NOTE : exec'd in ua server thread (not in worker thread)
+				auto client = this->client();
+				Q_CHECK_PTR(client);
+				// another read might be in flight already, only clear our own
+				if (m_replyRead == p_reply)
+				{
+					m_replyRead = nullptr;
+				}
+				if (client->m_disconnectRequested || client->getState() != QModbusState::ConnectedState)
+				{
+					if (p_reply)
+					{
+						p_reply->deleteLater();
+					}
+					this->setLastError(QModbusError::ReplyAbortedError);
+					this->abortRead(groupRead, index, QModbusError::ReplyAbortedError);
+					return;
+				}
+				// check if reply still valid
+				if (!p_reply)
+				{
+					this->setLastError(QModbusError::ReplyAbortedError);
+					this->abortRead(groupRead, index, QModbusError::ReplyAbortedError);
+					return;
+				}
+				// update block and values, or wait for the rest of the group
+				if (groupRead)
+				{
+					this->list()->updateGroupRead(
+						groupRead,
+						index,
+						p_reply->result().values(),
+						p_reply->error(),
+						QUaModbusDataBlock::replyException(p_reply),
+						*timestamp
+					);
+				}
+				else
+				{
+					this->updateFromRead(
+						p_reply->result().values(),
+						p_reply->error(),
+						QUaModbusDataBlock::replyException(p_reply),
+						*timestamp
+					);
+				}
+				// block data now reflects the counter, else it is read again on the next counter poll
+				if (counterPending >= 0 && p_reply->error() == QModbusError::NoError)
+				{
+					client->m_workerThread.execInThread([this, counterPending]() {
+						m_counterValue = counterPending;
+						if (m_counterPending == counterPending)
+						{
+							m_counterPending = -1;
+						}
+					});
+				}
+				// delete reply on next event loop exec
+				p_reply->deleteLater();
+				// a write completed or a trigger fired while reading, read again
+				client->m_workerThread.execInThread([this]() {
+					if (!m_readbackPending)
+					{
+						return;
+					}
+					m_readbackPending = false;
+					this->enqueueRead();
+				});
+			}, Qt::QueuedConnection);
+		return p_reply;
+	});
+	// a read of this block is queued already, the group cannot complete without this block
+	if (!queued && groupRead)
+	{
+		QTimer::singleShot(0, this, [this, groupRead, index]() {
+			this->abortRead(groupRead, index, QModbusError::ReplyAbortedError);
+		});
+	}
+}
+
+void QUaModbusDataBlock::abortRead(const QSharedPointer<QUaModbusGroupRead> &groupRead, const int &index, const QModbusError &error)
+{
+	// the group cannot complete without this block, it reports the error of its members
+	if (groupRead)
+	{
+		this->list()->updateGroupRead(groupRead, index, QVector<quint16>(), error, QModbusExceptionCode::NoException);
+		return;
+	}
+	// someone might be waiting for this read (readNow)
+	emit this->readFinished(error);
+}
+
+void QUaModbusDataBlock::enqueueCounterRead()
+{
+	auto client = this->client();
+	auto serverAddress = this->requestServerAddress();
+	client->m_scheduler->enqueue(serverAddress, this, QUaModbusScheduler::CounterRead,
+	[this, client, serverAddress]() -> QModbusReply* {
+		m_replyCounter = client->m_modbusClient->sendReadRequest(
+			QModbusDataUnit(
+				static_cast<QModbusDataUnit::RegisterType>(m_counterType),
+				m_counterAddress,
+				1
+			)
+			, serverAddress
+		);
+		if (!m_replyCounter)
+		{
+			if (!client->m_disconnectRequested)
+			{
+				emit this->updateLastError(QModbusError::ReplyAbortedError);
+			}
+			return nullptr;
+		}
+		if (m_replyCounter->isFinished())
+		{
+			m_replyCounter->deleteLater();
+			m_replyCounter = nullptr;
+			return nullptr;
+		}
+		// subscribe to finished
+		QObject::connect(m_replyCounter.data(), &QModbusReply::finished, this,
+			[this]() {
+				// NOTE : exec'd in ua server thread (not in worker thread)
+				auto client = this->client();
+				Q_CHECK_PTR(client);
+				auto reply = m_replyCounter;
+				m_replyCounter = nullptr;
+				if (!reply)
+				{
+					return;
+				}
+				// delete reply on next event loop exec
+				reply->deleteLater();
+				if (client->m_disconnectRequested || client->getState() != QModbusState::ConnectedState)
+				{
+					this->setLastError(QModbusError::ReplyAbortedError);
+					return;
+				}
+				auto error = reply->error();
+				if (error != QModbusError::NoError || reply->result().valueCount() != 1)
+				{
+					this->setLastError(error);
+					this->updateException(error, QUaModbusDataBlock::replyException(reply));
+					return;
+				}
+				// read the whole block only if the counter moved
+				// NOTE : counter is only taken once the block is read successfully
+				int counterValue = reply->result().value(0);
+				client->m_workerThread.execInThread([this, counterValue]() {
+					if (counterValue == m_counterValue)
+					{
+						return;
+					}
+					m_counterPending = counterValue;
+					if (m_replyRead)
+					{
+						m_readbackPending = true;
+						return;
+					}
+					this->enqueueRead();
+				});
+			}, Qt::QueuedConnection);
+		return m_replyCounter;
+	});
+}
+
+void QUaModbusDataBlock::readback()
+{
+	// exec in client thread
+	// NOTE : whoever waits for the read (readNow) is told in ua server thread why there is none
+	this->client()->m_workerThread.execInThread([this]() {
+		if (!this->isWellConfigured() || m_isBroadcast || m_isWriteOnly || !m_isEnabled)
+		{
+			QTimer::singleShot(0, this, [this]() {
+				emit this->readFinished(QModbusError::ConfigurationError);
+			});
+			return;
+		}
+		auto client = this->client();
+		if (client->getState() != QModbusState::ConnectedState)
+		{
+			QTimer::singleShot(0, this, [this, client]() {
+				emit this->readFinished(client->getLastError());
+			});
+			return;
+		}
+		// a read is on its way, read again when it finishes
+		if (m_replyRead)
+		{
+			m_readbackPending = true;
+			return;
+		}
+		// NOTE : coalesced if a read is already queued, that one is not sent yet and emits readFinished
+		this->enqueueRead();
+	});
+}
+
+bool QUaModbusDataBlock::resolveTrigger()
+{
+	QObject::disconnect(m_triggerConnection);
+	for (auto &connection : m_triggerWatch)
+	{
+		QObject::disconnect(connection);
+	}
+	m_triggerWatch.clear();
+	m_trigger     = nullptr;
+	m_triggerLast = QVariant();
+	auto strPath  = this->getTriggerValue();
+	if (strPath.isEmpty())
+	{
+		return true;
+	}
+	// NOTE : resolve again only if still missing, or if a rename might change what the path points to
+	auto resolveMissing = [this]() {
+		if (!m_trigger)
+		{
+			this->resolveTrigger();
+		}
+	};
+	auto resolveAgain = [this]() {
+		// lost the trigger, tell the user
+		bool wasResolved = m_trigger;
+		if (!this->resolveTrigger() && wasResolved)
+		{
+			this->logUnresolvedTrigger();
+		}
+	};
+	// value of this block, or of another block of the same client
+	auto strBlock = strPath.section('/', 0, -2);
+	auto strValue = strPath.section('/', -1);
+	QUaModbusDataBlock * block = strBlock.isEmpty() ? this : nullptr;
+	auto list = this->list();
+	m_triggerWatch << QObject::connect(list, &QUaNode::childAdded, this, resolveMissing);
+	for (auto other : list->blocks())
+	{
+		if (!strBlock.isEmpty())
+		{
+			m_triggerWatch << QObject::connect(other, &QUaNode::browseNameChanged, this, resolveAgain);
+		}
+		if (!block && other->browseName() == QUaQualifiedName(strBlock))
+		{
+			block = other;
+		}
+	}
+	if (!block)
+	{
+		return false;
+	}
+	m_triggerWatch << QObject::connect(block->values(), &QUaNode::childAdded, this, resolveMissing);
+	for (auto value : block->values()->values())
+	{
+		m_triggerWatch << QObject::connect(value, &QUaNode::browseNameChanged, this, resolveAgain);
+		if (!m_trigger && value->browseName() == QUaQualifiedName(strValue))
+		{
+			m_trigger = value;
+		}
+	}
+	if (!m_trigger)
+	{
+		return false;
+	}
+	m_triggerLast = m_trigger->getValue();
+	m_triggerConnection = QObject::connect(m_trigger, &QUaModbusValue::valueChanged, this, &QUaModbusDataBlock::on_triggerUpdated);
+	// NOTE : deleted value is still a child while being destroyed, resolve once it is gone
+	m_triggerWatch << QObject::connect(m_trigger, &QObject::destroyed, this, [this]() {
+		QTimer::singleShot(0, this, [this]() {
+			if (!this->resolveTrigger())
+			{
+				this->logUnresolvedTrigger();
+			}
+		});
+	});
+	return true;
+}
+
+void QUaModbusDataBlock::logUnresolvedTrigger()
+{
+	emit this->server()->logMessage(QUaLog(
+		tr("TriggerValue '%1' of Block %2 does not exist. Block is not triggered until it does.")
+			.arg(this->getTriggerValue()).arg(this->browseName().name()),
+		QUaLogLevel::Warning,
+		QUaLogCategory::Serialization
+	));
+}
+
+void QUaModbusDataBlock::updateException(const QModbusError & error, const QModbusExceptionCode & exceptionCode)
+{
+	if (exceptionCode != this->getExceptionCode())
+	{
+		this->exceptionCode()->setValue(exceptionCode);
+	}
+	// a busy or failing server is transient, rejecting the request itself is not
+	bool isRequestException =
+		exceptionCode == QModbusExceptionCode::IllegalFunction    ||
+		exceptionCode == QModbusExceptionCode::IllegalDataAddress ||
+		exceptionCode == QModbusExceptionCode::IllegalDataValue;
+	if (!isRequestException)
+	{
+		// any other outcome breaks the streak
+		m_exceptionCount = 0;
+		m_lastException  = QModbusExceptionCode::NoException;
+		// server accepts the request again
+		if (error == QModbusError::NoError)
+		{
+			this->liftQuarantine();
+		}
+		return;
+	}
+	// only the same exception in a row counts
+	if (exceptionCode != m_lastException)
+	{
+		m_exceptionCount = 0;
+		m_lastException  = exceptionCode;
+	}
+	m_exceptionCount++;
+	if (m_exceptionCount < m_quarantineAfter || this->getQuarantineInterval() == 0 || this->isQuarantined())
+	{
+		return;
+	}
+	// set in thread for safety, next read after a whole interval
+	this->client()->m_workerThread.execInThread([this]() {
+		m_isQuarantined = true;
+		m_quarantineProbe.start();
+	});
+	this->quarantined()->setValue(true);
+	// emit
+	emit this->quarantinedChanged(true);
+}
+
+QModbusExceptionCode QUaModbusDataBlock::replyException(QModbusReply * reply)
+{
+	if (reply->error() != QModbusError::ProtocolError || !reply->rawResult().isException())
+	{
+		return QModbusExceptionCode::NoException;
+	}
+	return static_cast<QModbusExceptionCode>(reply->rawResult().exceptionCode());
+}
+
+QSharedPointer<QDateTime> QUaModbusDataBlock::replyTimestamp(QModbusReply * reply)
+{
+	auto timestamp = QSharedPointer<QDateTime>::create();
+	// NOTE : connected before the queued handlers, so it is set before they are posted
+	//        ua server thread would add its own latency to the timestamp
+	QObject::connect(reply, &QModbusReply::finished, reply, [timestamp]() {
+		*timestamp = QDateTime::currentDateTimeUtc();
+	}, Qt::DirectConnection);
+	return timestamp;
+}
+
+bool QUaModbusDataBlock::loopRunning()
+{
+	return m_loopHandle >= 0 || m_alignedLoop || m_preciseLoop;
+}
+
+quint8 QUaModbusDataBlock::requestServerAddress() const
+{
+	// modbus broadcast address
+	if (m_isBroadcast)
+	{
+		return 0;
+	}
+	// block server address has precedence over the client's
+	if (m_serverAddressOverride >= 0)
+	{
+		return static_cast<quint8>(m_serverAddressOverride);
+	}
+	return this->client()->getServerAddress();
+}
+
+bool QUaModbusDataBlock::useReadWrite(const int & writeCount) const
+{
+	// broadcasts have no reply to read from
+	if (!m_isReadWrite || m_isWriteOnly || m_isBroadcast || m_registerType != QModbusDataBlockType::HoldingRegisters)
+	{
+		return false;
+	}
+	// FC23 reads at most 125 and writes at most 121 registers, else write only and let polling read
+	return m_valueCount <= 125u && writeCount <= 121;
+}
+
+void QUaModbusDataBlock::enqueueReadWrite(const QModbusDataUnit & dataToWrite, const std::function<void()>& written)
+{
+	auto client = this->client();
+	auto serverAddress = this->requestServerAddress();
+	client->m_scheduler->enqueue(serverAddress, this, QUaModbusScheduler::Write,
+	[this, client, dataToWrite, serverAddress, written]() -> QModbusReply* {
+		// if not supported by the server, write only and let polling read
+		bool isReadWrite = !m_readWriteUnsupported;
+		QPointer<QModbusReply> p_reply = isReadWrite ?
+			client->m_modbusClient->sendReadWriteRequest(
+				QModbusDataUnit(QModbusDataUnit::HoldingRegisters, m_startAddress, m_valueCount),
+				dataToWrite,
+				serverAddress
+			) :
+			client->m_modbusClient->sendWriteRequest(dataToWrite, serverAddress);
+		if (!p_reply)
 		{
-			if (!client->m_disconnectRequested)
-			{
-				emit this->updateLastError(QModbusError::ReplyAbortedError);
-			}
-			return;
+			emit this->updateLastError(QModbusError::ReplyAbortedError);
+			return nullptr;
 		}
-		// check if finished immediately (ignore)
-		if (m_replyRead->isFinished())
+		// broadcast replies finish immediately, there is no answer to wait for
+		if (p_reply->isFinished())
 		{
-			// broadcast replies return immediately
-			m_replyRead->deleteLater();
-			m_replyRead = nullptr;
-			return;
+			emit this->updateLastError(p_reply->error());
+			p_reply->deleteLater();
+			return nullptr;
 		}
+		auto timestamp = QUaModbusDataBlock::replyTimestamp(p_reply);
 		// subscribe to finished
-		QObject::connect(m_replyRead, &QModbusReply::finished, this,
-			[this]() {
-				// NOTE : exec'd in ua server thread (not in worker thread)
-				auto client = this->client();
-				Q_CHECK_PTR(client);
-				if (client->m_disconnectRequested || client->getState() != QModbusState::ConnectedState)
-				{
-					m_replyRead = nullptr;
-					this->setLastError(QModbusError::ReplyAbortedError);
-					return;
-				}
-				// check if reply still valid
-				if (!m_replyRead)
-				{
-					this->setLastError(QModbusError::ReplyAbortedError);
-					return;
-				}
-				// handle error
-				auto error = m_replyRead->error();
+		QObject::connect(p_reply.data(), &QModbusReply::finished, this,
+		[this, p_reply, dataToWrite, isReadWrite, written, timestamp]() {
+			// NOTE : exec'd in ua server thread (not in worker thread)
+			auto client = this->client();
+			// check if reply still valid
+			if (!p_reply)
+			{
+				this->setLastError(QModbusError::ReplyAbortedError);
+				return;
+			}
+			if (client->m_disconnectRequested || client->getState() != QModbusState::ConnectedState)
+			{
+				p_reply->deleteLater();
+				this->setLastError(QModbusError::ReplyAbortedError);
+				return;
+			}
+			auto error = p_reply->error();
+			// fall back to separate write and read
+			if (isReadWrite &&
+				error == QModbusError::ProtocolError &&
+				p_reply->rawResult().exceptionCode() == QModbusPdu::IllegalFunction)
+			{
+				p_reply->deleteLater();
+				client->m_workerThread.execInThread([this, dataToWrite, written]() {
+					m_readWriteUnsupported = true;
+					this->enqueueReadWrite(dataToWrite, written);
+				});
+				return;
+			}
+			if (isReadWrite)
+			{
+				this->updateFromRead(p_reply->result().values(), error, QUaModbusDataBlock::replyException(p_reply), *timestamp);
+			}
+			else
+			{
 				this->setLastError(error);
-				// update block value
-				QVector<quint16> data = m_replyRead->result().values();
-				// TODO : early exit when refactor QUaModbusValue::setValue
-				if (error == QModbusError::NoError)
-				{
-					Q_ASSERT(data.count() == m_valueCount);
-					this->setData(data, false);
-				}
-				// update modbus values and errors
-				auto values = this->values()->values();
-				for (auto value : values)
+				// show the confirmed value without waiting for the next poll
+				if (error == QModbusError::NoError && this->getReadbackAfterWrite())
 				{
-					value->setValue(data, error, m_firstSample);
+					this->readback();
 				}
-				// delete reply on next event loop exec
-				m_replyRead->deleteLater();
-				m_replyRead = nullptr;
-				m_firstSample = false;
-			}, Qt::QueuedConnection);
-		}, samplingTime);
-	Q_ASSERT(m_loopHandle > 0);
+			}
+			// delete reply on next event loop exec
+			p_reply->deleteLater();
+			if (written)
+			{
+				written();
+			}
+		}, Qt::QueuedConnection);
+		return p_reply;
+	// read start and count are sent as well
+	}, QUaModbusScheduler::writeRequestSize(dataToWrite.registerType(), dataToWrite.valueCount()) + 4);
 }
 
-bool QUaModbusDataBlock::loopRunning()
+void QUaModbusDataBlock::updateFromRead(const QVector<quint16>& data, const QModbusError & error, const QModbusExceptionCode & exceptionCode, const QDateTime &timestamp/* = QDateTime()*/)
+{
+	// handle error
+	this->setLastError(error);
+	this->updateException(error, exceptionCode);
+	// update block value
+	// TODO : early exit when refactor QUaModbusValue::setValue
+	if (error == QModbusError::NoError)
+	{
+		Q_ASSERT(data.count() == m_valueCount);
+		this->setData(data, false);
+		if (timestamp.isValid())
+		{
+			this->data()->setSourceTimestamp(timestamp);
+		}
+		this->captureFrame(data, timestamp.isValid() ? timestamp : QDateTime::currentDateTimeUtc());
+		m_lastUpdate.start();
+	}
+	// update modbus values and errors
+	auto values = this->values()->values();
+	for (auto value : values)
+	{
+		value->setValue(data, error, m_firstSample, timestamp);
+	}
+	m_firstSample = false;
+	// emit
+	emit this->readFinished(error);
+}
+
+void QUaModbusDataBlock::captureFrame(const QVector<quint16>& data, const QDateTime & timestamp)
 {
-	return m_loopHandle >= 0;
+	QUaModbusFrame frame;
+	frame.timestamp = timestamp;
+	frame.data      = data;
+	if (m_burstRunning)
+	{
+		m_burstFrames << frame;
+		return;
+	}
+	// ring buffer of the frames before the trigger
+	auto preTriggerFrames = this->getPreTriggerFrames();
+	if (preTriggerFrames == 0)
+	{
+		return;
+	}
+	m_preTrigger << frame;
+	while (static_cast<quint32>(m_preTrigger.count()) > preTriggerFrames)
+	{
+		m_preTrigger.removeFirst();
+	}
 }
 
 void QUaModbusDataBlock::setModbusData(const QVector<quint16>& data)
@@ -452,6 +2042,10 @@ void QUaModbusDataBlock::setModbusData(const QVector<quint16>& data)
 		{
 			return;
 		}
+		if (!m_isEnabled)
+		{
+			return;
+		}
 		if (m_startAddress < 0)
 		{
 			emit this->updateLastError(QModbusError::ConfigurationError);
@@ -476,32 +2070,54 @@ void QUaModbusDataBlock::setModbusData(const QVector<quint16>& data)
 			m_startAddress, 
 			data
 		);
-		// create and send request
-		auto serverAddress = client->getServerAddress();
-		QModbusReply * p_reply = client->m_modbusClient->sendWriteRequest(dataToWrite, serverAddress);
-		if (!p_reply)
+		// write and read back in the same transaction
+		if (this->useReadWrite(dataToWrite.valueCount()))
 		{
-			emit this->updateLastError(QModbusError::ReplyAbortedError);
+			this->enqueueReadWrite(dataToWrite, nullptr);
 			return;
 		}
-		// subscribe to finished
-		QObject::connect(p_reply, &QModbusReply::finished, this, 
-		[this, p_reply]() mutable {
-			// NOTE : exec'd in ua server thread (not in worker thread)
-			// check if reply still valid
+		// enqueue request in scheduler, so the bus is shared fairly with other blocks
+		auto serverAddress = this->requestServerAddress();
+		client->m_scheduler->enqueue(serverAddress, this, QUaModbusScheduler::Write,
+		[this, client, dataToWrite, serverAddress]() -> QModbusReply* {
+			QPointer<QModbusReply> p_reply = client->m_modbusClient->sendWriteRequest(dataToWrite, serverAddress);
 			if (!p_reply)
 			{
-				auto error = QModbusError::ReplyAbortedError;
-				this->setLastError(error);
-				return;
+				emit this->updateLastError(QModbusError::ReplyAbortedError);
+				return nullptr;
 			}
-			// handle error
-			auto error = p_reply->error();
-			this->setLastError(error);
-			// delete reply on next event loop exec
-			p_reply->deleteLater();
-			p_reply = nullptr;
-		}, Qt::QueuedConnection);
+			// broadcast replies finish immediately, there is no answer to wait for
+			if (p_reply->isFinished())
+			{
+				emit this->updateLastError(p_reply->error());
+				p_reply->deleteLater();
+				return nullptr;
+			}
+			// subscribe to finished
+			QObject::connect(p_reply.data(), &QModbusReply::finished, this, 
+			[this, p_reply]() mutable {
+				// NOTE : exec'd in ua server thread (not in worker thread)
+				// check if reply still valid
+				if (!p_reply)
+				{
+					auto error = QModbusError::ReplyAbortedError;
+					this->setLastError(error);
+					return;
+				}
+				// handle error
+				auto error = p_reply->error();
+				this->setLastError(error);
+				// delete reply on next event loop exec
+				p_reply->deleteLater();
+				p_reply = nullptr;
+				// show the confirmed value without waiting for the next poll
+				if (error == QModbusError::NoError && this->getReadbackAfterWrite())
+				{
+					this->readback();
+				}
+			}, Qt::QueuedConnection);
+			return p_reply;
+		}, QUaModbusScheduler::writeRequestSize(dataToWrite.registerType(), dataToWrite.valueCount()));
 	});
 }
 
@@ -522,6 +2138,25 @@ QDomElement QUaModbusDataBlock::toDomElement(QDomDocument & domDoc) const
 	elemBlock.setAttribute("Address"     , getAddress());
 	elemBlock.setAttribute("Size"        , getSize());
 	elemBlock.setAttribute("SamplingTime", getSamplingTime());
+	elemBlock.setAttribute("ServerAddress", getServerAddress());
+	elemBlock.setAttribute("Broadcast"    , getBroadcast());
+	elemBlock.setAttribute("ReadWriteMultiple", getReadWriteMultiple());
+	elemBlock.setAttribute("ReadbackAfterWrite", getReadbackAfterWrite());
+	elemBlock.setAttribute("QuarantineInterval", getQuarantineInterval());
+	elemBlock.setAttribute("ChangeCounterType"   , QMetaEnum::fromType<QModbusDataBlockType>().valueToKey(getChangeCounterType()));
+	elemBlock.setAttribute("ChangeCounterAddress", getChangeCounterAddress());
+	elemBlock.setAttribute("MaxReadInterval"     , getMaxReadInterval());
+	elemBlock.setAttribute("TriggerValue", getTriggerValue());
+	elemBlock.setAttribute("TriggerMode" , QMetaEnum::fromType<QModbusTriggerMode>().valueToKey(getTriggerMode()));
+	elemBlock.setAttribute("ReadGroup"   , getReadGroup());
+	elemBlock.setAttribute("AlignToClock", getAlignToClock());
+	elemBlock.setAttribute("BurstSamplingTime", getBurstSamplingTime());
+	elemBlock.setAttribute("BurstDuration"    , getBurstDuration    ());
+	elemBlock.setAttribute("PreTriggerFrames" , getPreTriggerFrames ());
+	elemBlock.setAttribute("BurstOnTrigger"   , getBurstOnTrigger   ());
+	elemBlock.setAttribute("PollMode", QMetaEnum::fromType<QModbusPollMode>().valueToKey(getPollMode()));
+	elemBlock.setAttribute("MaxAge"  , getMaxAge());
+	elemBlock.setAttribute("Enabled" , getEnabled());
 	// add value list element
 	auto elemValueList = const_cast<QUaModbusDataBlock*>(this)->values()->toDomElement(domDoc);
 	elemBlock.appendChild(elemValueList);
@@ -538,76 +2173,383 @@ void QUaModbusDataBlock::fromDomElement(QDomElement & domElem, QQueue<QUaLog>& e
 	// load permissions if any
 	if (domElem.hasAttribute("Permissions") && !domElem.attribute("Permissions").isEmpty())
 	{
-		QString strError = this->setPermissions(domElem.attribute("Permissions"));
-		if (strError.contains("Error"))
+		QString strError = this->setPermissions(domElem.attribute("Permissions"));
+		if (strError.contains("Error"))
+		{
+			errorLogs << QUaLog(
+				strError,
+				QUaLogLevel::Error,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+#endif // QUA_ACCESS_CONTROL
+	bool bOK;
+	// Type
+	auto type = QMetaEnum::fromType<QModbusDataBlockType>().keysToValue(domElem.attribute("Type").toUtf8(), &bOK);
+	if (bOK)
+	{
+		this->type()->setValue(type);
+		// NOTE : force internal update
+		this->on_typeChanged(type, true);
+	}
+	else
+	{
+		errorLogs << QUaLog(
+			tr("Invalid Type attribute '%1' in Block %2. Default value set.").arg(type).arg(strBrowseName),
+			QUaLogLevel::Warning,
+			QUaLogCategory::Serialization
+		);
+	}
+	
+	// Address
+	auto address = domElem.attribute("Address").toInt(&bOK);
+	if (bOK)
+	{
+		this->setAddress(address);
+	}
+	else
+	{
+		errorLogs << QUaLog(
+			tr("Invalid Address attribute '%1' in Block %2. Default value set.").arg(address).arg(strBrowseName),
+			QUaLogLevel::Warning,
+			QUaLogCategory::Serialization
+		);
+	}
+	// Size
+	auto size = domElem.attribute("Size").toUInt(&bOK);
+	if (bOK)
+	{
+		this->setSize(size);
+	}
+	else
+	{
+		errorLogs << QUaLog(
+			tr("Invalid Size attribute '%1' in Block %2. Default value set.").arg(size).arg(strBrowseName),
+			QUaLogLevel::Warning,
+			QUaLogCategory::Serialization
+		);
+	}
+	// SamplingTime
+	auto samplingTime = domElem.attribute("SamplingTime").toUInt(&bOK);
+	if (bOK)
+	{
+		this->setSamplingTime(samplingTime);
+	}
+	else
+	{
+		errorLogs << QUaLog(
+			tr("Invalid SamplingTime attribute '%1' in Block %2. Default value set.").arg(samplingTime).arg(strBrowseName),
+			QUaLogLevel::Warning,
+			QUaLogCategory::Serialization
+		);
+	}
+	// ServerAddress (optional, older configurations do not have it)
+	if (domElem.hasAttribute("ServerAddress"))
+	{
+		auto serverAddress = domElem.attribute("ServerAddress").toInt(&bOK);
+		if (bOK)
+		{
+			this->setServerAddress(serverAddress);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid ServerAddress attribute '%1' in Block %2. Default value set.").arg(serverAddress).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// Broadcast (optional)
+	if (domElem.hasAttribute("Broadcast"))
+	{
+		auto broadcast = (bool)domElem.attribute("Broadcast").toUInt(&bOK);
+		if (bOK && broadcast && !this->canBroadcast())
+		{
+			errorLogs << QUaLog(
+				tr("Broadcast attribute ignored in Block %1. Only RTU serial clients can broadcast.").arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+		else if (bOK)
+		{
+			this->setBroadcast(broadcast);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid Broadcast attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("Broadcast")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// ReadWriteMultiple (optional)
+	if (domElem.hasAttribute("ReadWriteMultiple"))
+	{
+		auto readWriteMultiple = (bool)domElem.attribute("ReadWriteMultiple").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setReadWriteMultiple(readWriteMultiple);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid ReadWriteMultiple attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("ReadWriteMultiple")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// ReadbackAfterWrite (optional)
+	if (domElem.hasAttribute("ReadbackAfterWrite"))
+	{
+		auto readbackAfterWrite = (bool)domElem.attribute("ReadbackAfterWrite").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setReadbackAfterWrite(readbackAfterWrite);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid ReadbackAfterWrite attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("ReadbackAfterWrite")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// QuarantineInterval (optional)
+	if (domElem.hasAttribute("QuarantineInterval"))
+	{
+		auto quarantineInterval = domElem.attribute("QuarantineInterval").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setQuarantineInterval(quarantineInterval);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid QuarantineInterval attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("QuarantineInterval")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// ChangeCounterType (optional)
+	if (domElem.hasAttribute("ChangeCounterType"))
+	{
+		auto changeCounterType = QMetaEnum::fromType<QModbusDataBlockType>().keysToValue(domElem.attribute("ChangeCounterType").toUtf8(), &bOK);
+		if (bOK)
+		{
+			this->setChangeCounterType(static_cast<QModbusDataBlockType>(changeCounterType));
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid ChangeCounterType attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("ChangeCounterType")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// ChangeCounterAddress (optional)
+	if (domElem.hasAttribute("ChangeCounterAddress"))
+	{
+		auto changeCounterAddress = domElem.attribute("ChangeCounterAddress").toInt(&bOK);
+		if (bOK)
+		{
+			this->setChangeCounterAddress(changeCounterAddress);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid ChangeCounterAddress attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("ChangeCounterAddress")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// MaxReadInterval (optional)
+	if (domElem.hasAttribute("MaxReadInterval"))
+	{
+		auto maxReadInterval = domElem.attribute("MaxReadInterval").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setMaxReadInterval(maxReadInterval);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid MaxReadInterval attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("MaxReadInterval")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// TriggerMode (optional)
+	if (domElem.hasAttribute("TriggerMode"))
+	{
+		auto triggerMode = QMetaEnum::fromType<QModbusTriggerMode>().keysToValue(domElem.attribute("TriggerMode").toUtf8(), &bOK);
+		if (bOK)
+		{
+			this->setTriggerMode(static_cast<QModbusTriggerMode>(triggerMode));
+		}
+		else
 		{
 			errorLogs << QUaLog(
-				strError,
-				QUaLogLevel::Error,
+				tr("Invalid TriggerMode attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("TriggerMode")).arg(strBrowseName),
+				QUaLogLevel::Warning,
 				QUaLogCategory::Serialization
 			);
 		}
 	}
-#endif // QUA_ACCESS_CONTROL
-	bool bOK;
-	// Type
-	auto type = QMetaEnum::fromType<QModbusDataBlockType>().keysToValue(domElem.attribute("Type").toUtf8(), &bOK);
-	if (bOK)
+	// TriggerValue (optional)
+	if (domElem.hasAttribute("TriggerValue"))
 	{
-		this->type()->setValue(type);
-		// NOTE : force internal update
-		this->on_typeChanged(type, true);
+		this->setTriggerValue(domElem.attribute("TriggerValue"));
 	}
-	else
+	// ReadGroup (optional)
+	if (domElem.hasAttribute("ReadGroup"))
 	{
-		errorLogs << QUaLog(
-			tr("Invalid Type attribute '%1' in Block %2. Default value set.").arg(type).arg(strBrowseName),
-			QUaLogLevel::Warning,
-			QUaLogCategory::Serialization
-		);
+		this->setReadGroup(domElem.attribute("ReadGroup"));
 	}
-	
-	// Address
-	auto address = domElem.attribute("Address").toInt(&bOK);
-	if (bOK)
+	// AlignToClock (optional)
+	if (domElem.hasAttribute("AlignToClock"))
 	{
-		this->setAddress(address);
+		auto alignToClock = (bool)domElem.attribute("AlignToClock").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setAlignToClock(alignToClock);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid AlignToClock attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("AlignToClock")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
 	}
-	else
+	// BurstSamplingTime (optional)
+	if (domElem.hasAttribute("BurstSamplingTime"))
 	{
-		errorLogs << QUaLog(
-			tr("Invalid Address attribute '%1' in Block %2. Default value set.").arg(address).arg(strBrowseName),
-			QUaLogLevel::Warning,
-			QUaLogCategory::Serialization
-		);
+		auto burstSamplingTime = domElem.attribute("BurstSamplingTime").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setBurstSamplingTime(burstSamplingTime);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid BurstSamplingTime attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("BurstSamplingTime")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
 	}
-	// Size
-	auto size = domElem.attribute("Size").toUInt(&bOK);
-	if (bOK)
+	// BurstDuration (optional)
+	if (domElem.hasAttribute("BurstDuration"))
 	{
-		this->setSize(size);
+		auto burstDuration = domElem.attribute("BurstDuration").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setBurstDuration(burstDuration);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid BurstDuration attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("BurstDuration")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
 	}
-	else
+	// PreTriggerFrames (optional)
+	if (domElem.hasAttribute("PreTriggerFrames"))
 	{
-		errorLogs << QUaLog(
-			tr("Invalid Size attribute '%1' in Block %2. Default value set.").arg(size).arg(strBrowseName),
-			QUaLogLevel::Warning,
-			QUaLogCategory::Serialization
-		);
+		auto preTriggerFrames = domElem.attribute("PreTriggerFrames").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setPreTriggerFrames(preTriggerFrames);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid PreTriggerFrames attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("PreTriggerFrames")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
 	}
-	// SamplingTime
-	auto samplingTime = domElem.attribute("SamplingTime").toUInt(&bOK);
-	if (bOK)
+	// BurstOnTrigger (optional)
+	if (domElem.hasAttribute("BurstOnTrigger"))
 	{
-		this->setSamplingTime(samplingTime);
+		auto burstOnTrigger = (bool)domElem.attribute("BurstOnTrigger").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setBurstOnTrigger(burstOnTrigger);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid BurstOnTrigger attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("BurstOnTrigger")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
 	}
-	else
+	// PollMode (optional)
+	if (domElem.hasAttribute("PollMode"))
 	{
-		errorLogs << QUaLog(
-			tr("Invalid SamplingTime attribute '%1' in Block %2. Default value set.").arg(samplingTime).arg(strBrowseName),
-			QUaLogLevel::Warning,
-			QUaLogCategory::Serialization
-		);
+		auto pollMode = QMetaEnum::fromType<QModbusPollMode>().keysToValue(domElem.attribute("PollMode").toUtf8(), &bOK);
+		if (bOK)
+		{
+			this->setPollMode(static_cast<QModbusPollMode>(pollMode));
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid PollMode attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("PollMode")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// MaxAge (optional)
+	if (domElem.hasAttribute("MaxAge"))
+	{
+		auto maxAge = domElem.attribute("MaxAge").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setMaxAge(maxAge);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid MaxAge attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("MaxAge")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// Enabled (optional)
+	if (domElem.hasAttribute("Enabled"))
+	{
+		auto enabled = (bool)domElem.attribute("Enabled").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setEnabled(enabled);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid Enabled attribute '%1' in Block %2. Default value set.").arg(domElem.attribute("Enabled")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
 	}
 	// get value list
 	QDomElement elemValueList = domElem.firstChildElement(QUaModbusValueList::staticMetaObject.className());
@@ -687,6 +2629,246 @@ void QUaModbusDataBlock::setSamplingTime(const quint32 & samplingTime)
 	this->on_samplingTimeChanged(samplingTime, true);
 }
 
+int QUaModbusDataBlock::getServerAddress() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->serverAddress()->value().toInt();
+}
+
+void QUaModbusDataBlock::setServerAddress(const int & serverAddress)
+{
+	this->serverAddress()->setValue(serverAddress);
+	this->on_serverAddressChanged(serverAddress, true);
+}
+
+bool QUaModbusDataBlock::getReadWriteMultiple() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->readWriteMultiple()->value().toBool();
+}
+
+void QUaModbusDataBlock::setReadWriteMultiple(const bool & readWriteMultiple)
+{
+	this->readWriteMultiple()->setValue(readWriteMultiple);
+	this->on_readWriteMultipleChanged(readWriteMultiple, true);
+}
+
+QModbusExceptionCode QUaModbusDataBlock::getExceptionCode() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->exceptionCode()->value().value<QModbusExceptionCode>();
+}
+
+quint32 QUaModbusDataBlock::getQuarantineInterval() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->quarantineInterval()->value().value<quint32>();
+}
+
+void QUaModbusDataBlock::setQuarantineInterval(const quint32 & quarantineInterval)
+{
+	this->quarantineInterval()->setValue(quarantineInterval);
+	this->on_quarantineIntervalChanged(quarantineInterval, true);
+}
+
+bool QUaModbusDataBlock::isQuarantined() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->quarantined()->value().toBool();
+}
+
+QModbusDataBlockType QUaModbusDataBlock::getChangeCounterType() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->changeCounterType()->value().value<QModbusDataBlockType>();
+}
+
+void QUaModbusDataBlock::setChangeCounterType(const QModbusDataBlockType & changeCounterType)
+{
+	this->changeCounterType()->setValue(changeCounterType);
+	this->on_changeCounterTypeChanged(changeCounterType, true);
+}
+
+int QUaModbusDataBlock::getChangeCounterAddress() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->changeCounterAddress()->value().toInt();
+}
+
+void QUaModbusDataBlock::setChangeCounterAddress(const int & changeCounterAddress)
+{
+	this->changeCounterAddress()->setValue(changeCounterAddress);
+	this->on_changeCounterAddressChanged(changeCounterAddress, true);
+}
+
+quint32 QUaModbusDataBlock::getMaxReadInterval() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->maxReadInterval()->value().value<quint32>();
+}
+
+void QUaModbusDataBlock::setMaxReadInterval(const quint32 & maxReadInterval)
+{
+	this->maxReadInterval()->setValue(maxReadInterval);
+	this->on_maxReadIntervalChanged(maxReadInterval, true);
+}
+
+QString QUaModbusDataBlock::getTriggerValue() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->triggerValue()->value().toString();
+}
+
+void QUaModbusDataBlock::setTriggerValue(const QString & strTriggerValue)
+{
+	this->triggerValue()->setValue(strTriggerValue);
+	this->on_triggerValueChanged(strTriggerValue, true);
+}
+
+QModbusTriggerMode QUaModbusDataBlock::getTriggerMode() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->triggerMode()->value().value<QModbusTriggerMode>();
+}
+
+void QUaModbusDataBlock::setTriggerMode(const QModbusTriggerMode & triggerMode)
+{
+	this->triggerMode()->setValue(triggerMode);
+	this->on_triggerModeChanged(triggerMode, true);
+}
+
+QString QUaModbusDataBlock::getReadGroup() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->readGroup()->value().toString();
+}
+
+void QUaModbusDataBlock::setReadGroup(const QString & strReadGroup)
+{
+	this->readGroup()->setValue(strReadGroup);
+	this->on_readGroupChanged(strReadGroup, true);
+}
+
+double QUaModbusDataBlock::getAchievedPeriod() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->achievedPeriod()->value().toDouble();
+}
+
+double QUaModbusDataBlock::getPeriodJitter() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->periodJitter()->value().toDouble();
+}
+
+quint32 QUaModbusDataBlock::getBurstSamplingTime() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->burstSamplingTime()->value().value<quint32>();
+}
+
+void QUaModbusDataBlock::setBurstSamplingTime(const quint32 & burstSamplingTime)
+{
+	this->burstSamplingTime()->setValue(burstSamplingTime);
+	this->on_burstSamplingTimeChanged(burstSamplingTime, true);
+}
+
+quint32 QUaModbusDataBlock::getBurstDuration() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->burstDuration()->value().value<quint32>();
+}
+
+void QUaModbusDataBlock::setBurstDuration(const quint32 & burstDuration)
+{
+	this->burstDuration()->setValue(burstDuration);
+	this->on_burstDurationChanged(burstDuration, true);
+}
+
+quint32 QUaModbusDataBlock::getPreTriggerFrames() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->preTriggerFrames()->value().value<quint32>();
+}
+
+void QUaModbusDataBlock::setPreTriggerFrames(const quint32 & preTriggerFrames)
+{
+	this->preTriggerFrames()->setValue(preTriggerFrames);
+	this->on_preTriggerFramesChanged(preTriggerFrames, true);
+}
+
+bool QUaModbusDataBlock::getBurstOnTrigger() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->burstOnTrigger()->value().toBool();
+}
+
+void QUaModbusDataBlock::setBurstOnTrigger(const bool & burstOnTrigger)
+{
+	this->burstOnTrigger()->setValue(burstOnTrigger);
+	this->on_burstOnTriggerChanged(burstOnTrigger, true);
+}
+
+bool QUaModbusDataBlock::isBurstActive() const
+{
+	return m_burstRunning;
+}
+
+QModbusPollMode QUaModbusDataBlock::getPollMode() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->pollMode()->value().value<QModbusPollMode>();
+}
+
+void QUaModbusDataBlock::setPollMode(const QModbusPollMode & pollMode)
+{
+	this->pollMode()->setValue(pollMode);
+	this->on_pollModeChanged(pollMode, true);
+}
+
+quint32 QUaModbusDataBlock::getMaxAge() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->maxAge()->value().value<quint32>();
+}
+
+void QUaModbusDataBlock::setMaxAge(const quint32 & maxAge)
+{
+	this->maxAge()->setValue(maxAge);
+	this->on_maxAgeChanged(maxAge, true);
+}
+
+bool QUaModbusDataBlock::getEnabled() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->enabled()->value().toBool();
+}
+
+void QUaModbusDataBlock::setEnabled(const bool & enabled)
+{
+	this->enabled()->setValue(enabled);
+	this->on_enabledChanged(enabled, true);
+}
+
+bool QUaModbusDataBlock::getAlignToClock() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->alignToClock()->value().toBool();
+}
+
+void QUaModbusDataBlock::setAlignToClock(const bool & alignToClock)
+{
+	this->alignToClock()->setValue(alignToClock);
+	this->on_alignToClockChanged(alignToClock, true);
+}
+
+bool QUaModbusDataBlock::getReadbackAfterWrite() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->readbackAfterWrite()->value().toBool();
+}
+
+void QUaModbusDataBlock::setReadbackAfterWrite(const bool & readbackAfterWrite)
+{
+	this->readbackAfterWrite()->setValue(readbackAfterWrite);
+	this->on_readbackAfterWriteChanged(readbackAfterWrite, true);
+}
+
+bool QUaModbusDataBlock::getBroadcast() const
+{
+	return const_cast<QUaModbusDataBlock*>(this)->broadcast()->value().toBool();
+}
+
+void QUaModbusDataBlock::setBroadcast(const bool & broadcast)
+{
+	this->broadcast()->setValue(broadcast);
+	this->on_broadcastChanged(broadcast, true);
+}
+
+bool QUaModbusDataBlock::canBroadcast() const
+{
+	auto client = this->client();
+	return client && client->getType() == QModbusClientType::Serial;
+}
+
 QVector<quint16> QUaModbusDataBlock::getData() const
 {
 	return QUaModbusDataBlock::variantToInt16Vect(const_cast<QUaModbusDataBlock*>(this)->data()->value());
@@ -12,10 +12,19 @@
 
 #include <QDomDocument>
 #include <QDomElement>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QSharedPointer>
+#include <QDateTime>
+#include <QTimer>
+#include <QMutex>
+
+#include <functional>
 
 class QUaModbusClient;
 class QUaModbusDataBlockList;
 class QUaModbusValue;
+struct QUaModbusGroupRead;
 
 #include "quamodbusvaluelist.h"
 
@@ -34,14 +43,38 @@ class QUaModbusDataBlock : public QUaBaseObjectProtected
     Q_OBJECT
 
 	// UA properties
-	Q_PROPERTY(QUaProperty * Type         READ type        )
-	Q_PROPERTY(QUaProperty * Address      READ address     )
-	Q_PROPERTY(QUaProperty * Size         READ size        )
-	Q_PROPERTY(QUaProperty * SamplingTime READ samplingTime)
+	Q_PROPERTY(QUaProperty * Type          READ type         )
+	Q_PROPERTY(QUaProperty * Address       READ address      )
+	Q_PROPERTY(QUaProperty * Size          READ size         )
+	Q_PROPERTY(QUaProperty * SamplingTime  READ samplingTime )
+	Q_PROPERTY(QUaProperty * ServerAddress READ serverAddress)
+	Q_PROPERTY(QUaProperty * Broadcast     READ broadcast    )
+	Q_PROPERTY(QUaProperty * ReadWriteMultiple READ readWriteMultiple)
+	Q_PROPERTY(QUaProperty * ReadbackAfterWrite READ readbackAfterWrite)
+	Q_PROPERTY(QUaProperty * QuarantineInterval READ quarantineInterval)
+	Q_PROPERTY(QUaProperty * ChangeCounterType    READ changeCounterType   )
+	Q_PROPERTY(QUaProperty * ChangeCounterAddress READ changeCounterAddress)
+	Q_PROPERTY(QUaProperty * MaxReadInterval      READ maxReadInterval     )
+	Q_PROPERTY(QUaProperty * TriggerValue READ triggerValue)
+	Q_PROPERTY(QUaProperty * TriggerMode  READ triggerMode )
+	Q_PROPERTY(QUaProperty * ReadGroup    READ readGroup   )
+	Q_PROPERTY(QUaProperty * AlignToClock READ alignToClock)
+	Q_PROPERTY(QUaProperty * BurstSamplingTime READ burstSamplingTime)
+	Q_PROPERTY(QUaProperty * BurstDuration     READ burstDuration    )
+	Q_PROPERTY(QUaProperty * PreTriggerFrames  READ preTriggerFrames )
+	Q_PROPERTY(QUaProperty * BurstOnTrigger    READ burstOnTrigger   )
+	Q_PROPERTY(QUaProperty * PollMode READ pollMode)
+	Q_PROPERTY(QUaProperty * MaxAge   READ maxAge  )
+	Q_PROPERTY(QUaProperty * Enabled  READ enabled )
 
 	// UA variables
 	Q_PROPERTY(QUaBaseDataVariable * Data      READ data     )
 	Q_PROPERTY(QUaBaseDataVariable * LastError READ lastError)
+	Q_PROPERTY(QUaBaseDataVariable * ExceptionCode READ exceptionCode)
+	Q_PROPERTY(QUaBaseDataVariable * Quarantined   READ quarantined  )
+	Q_PROPERTY(QUaBaseDataVariable * AchievedPeriod READ achievedPeriod)
+	Q_PROPERTY(QUaBaseDataVariable * PeriodJitter   READ periodJitter  )
+	Q_PROPERTY(QUaBaseDataVariable * BurstActive    READ burstActive   )
 
 	// UA objects
 	Q_PROPERTY(QUaModbusValueList * Values READ values)
@@ -62,17 +95,79 @@ public:
 	Q_ENUM(RegisterType)
 	typedef QUaModbusDataBlock::RegisterType QModbusDataBlockType;
 
+	// register as Q_ENUM
+	enum ExceptionCode
+	{
+		NoException                        = 0,
+		IllegalFunction                    = QModbusPdu::ExceptionCode::IllegalFunction                   ,
+		IllegalDataAddress                 = QModbusPdu::ExceptionCode::IllegalDataAddress                ,
+		IllegalDataValue                   = QModbusPdu::ExceptionCode::IllegalDataValue                  ,
+		ServerDeviceFailure                = QModbusPdu::ExceptionCode::ServerDeviceFailure               ,
+		Acknowledge                        = QModbusPdu::ExceptionCode::Acknowledge                       ,
+		ServerDeviceBusy                   = QModbusPdu::ExceptionCode::ServerDeviceBusy                  ,
+		NegativeAcknowledge                = QModbusPdu::ExceptionCode::NegativeAcknowledge               ,
+		MemoryParityError                  = QModbusPdu::ExceptionCode::MemoryParityError                 ,
+		GatewayPathUnavailable             = QModbusPdu::ExceptionCode::GatewayPathUnavailable            ,
+		GatewayTargetDeviceFailedToRespond = QModbusPdu::ExceptionCode::GatewayTargetDeviceFailedToRespond,
+		ExtendedException                  = QModbusPdu::ExceptionCode::ExtendedException
+	};
+	Q_ENUM(ExceptionCode)
+	typedef QUaModbusDataBlock::ExceptionCode QModbusExceptionCode;
+
+	enum TriggerMode
+	{
+		Change  = 0, // any change of the trigger value
+		Rising  = 1, // trigger value goes from zero to non-zero
+		Falling = 2  // trigger value goes from non-zero to zero
+	};
+	Q_ENUM(TriggerMode)
+	typedef QUaModbusDataBlock::TriggerMode QModbusTriggerMode;
+
+	enum PollMode
+	{
+		Periodic  = 0, // read at the sampling time
+		OnDemand  = 1, // only read when requested (ReadNow, trigger value or burst capture)
+		OnConnect = 2, // read once each time the client connects, then as OnDemand
+		WriteOnly = 3  // never read, writes use the last written data
+	};
+	Q_ENUM(PollMode)
+	typedef QUaModbusDataBlock::PollMode QModbusPollMode;
+
 	// UA properties
 
-	QUaProperty * type        ();
-	QUaProperty * address     ();
-	QUaProperty * size        ();
-	QUaProperty * samplingTime();
+	QUaProperty * type         ();
+	QUaProperty * address      ();
+	QUaProperty * size         ();
+	QUaProperty * samplingTime ();
+	QUaProperty * serverAddress();
+	QUaProperty * broadcast    ();
+	QUaProperty * readWriteMultiple();
+	QUaProperty * readbackAfterWrite();
+	QUaProperty * quarantineInterval();
+	QUaProperty * changeCounterType   ();
+	QUaProperty * changeCounterAddress();
+	QUaProperty * maxReadInterval     ();
+	QUaProperty * triggerValue();
+	QUaProperty * triggerMode ();
+	QUaProperty * readGroup   ();
+	QUaProperty * alignToClock();
+	QUaProperty * burstSamplingTime();
+	QUaProperty * burstDuration    ();
+	QUaProperty * preTriggerFrames ();
+	QUaProperty * burstOnTrigger   ();
+	QUaProperty * pollMode();
+	QUaProperty * maxAge  ();
+	QUaProperty * enabled ();
 
 	// UA variables
 
 	QUaBaseDataVariable * data();
 	QUaBaseDataVariable * lastError();
+	QUaBaseDataVariable * exceptionCode();
+	QUaBaseDataVariable * quarantined();
+	QUaBaseDataVariable * achievedPeriod();
+	QUaBaseDataVariable * periodJitter();
+	QUaBaseDataVariable * burstActive();
 
 	// UA objects
 
@@ -81,6 +176,18 @@ public:
 	// UA methods
 
 	Q_INVOKABLE void remove();
+	// poll again at the sampling time
+	Q_INVOKABLE void liftQuarantine();
+	// read once, readFinished is emitted when done (right away if the data is not older than MaxAge)
+	// NOTE : the UA method returns right away, UA clients see the outcome in Data and LastError only
+	Q_INVOKABLE void readNow();
+	// CSV histogram of the deviation (ms) of the achieved poll period from the sampling time
+	Q_INVOKABLE QString pollTiming();
+	Q_INVOKABLE void    resetPollTiming();
+	// poll at burst rate for the burst duration, keeping every frame read
+	Q_INVOKABLE void    captureBurst();
+	// CSV with the frames of the last burst capture, offset (ms) is relative to the trigger
+	Q_INVOKABLE QString burstCapture();
 
 	// C++ API (all is read/write)
 
@@ -96,12 +203,104 @@ public:
 	quint32 getSamplingTime() const;
 	void    setSamplingTime(const quint32 &samplingTime);
 
+	// NOTE : -1 means use the server address of the client
+	int  getServerAddress() const;
+	void setServerAddress(const int &serverAddress);
+
+	// NOTE : broadcast blocks are write only, sent to all servers (unit id 0) without reply
+	//        only on rtu serial clients, unit id 0 is just another unit of a tcp gateway
+	bool getBroadcast() const;
+	void setBroadcast(const bool &broadcast);
+	bool canBroadcast() const;
+
+	// NOTE : holding registers only, writes use FC23 to also read the block in the same transaction
+	bool getReadWriteMultiple() const;
+	void setReadWriteMultiple(const bool &readWriteMultiple);
+
+	// NOTE : reads the block as soon as a write succeeds, reads are coalesced for bursts of writes
+	bool getReadbackAfterWrite() const;
+	void setReadbackAfterWrite(const bool &readbackAfterWrite);
+
 	QVector<quint16> getData() const;
 	void             setData(const QVector<quint16> &data, const bool &writeModbus = true);
 
 	QModbusError getLastError() const;
 	void         setLastError(const QModbusError &error);
 
+	// exception of the last read response, if LastError is ProtocolError
+	QModbusExceptionCode getExceptionCode() const;
+
+	// NOTE : a block answered with the same request exception (illegal function, address or value)
+	//        several times in a row is quarantined, only read once per interval (ms, 0 disables)
+	quint32 getQuarantineInterval() const;
+	void    setQuarantineInterval(const quint32 &quarantineInterval);
+
+	bool isQuarantined() const;
+
+	// NOTE : if the address is valid, only this register is read at the sampling time
+	//        and the whole block only when its value changes (e.g. a data changed sequence counter)
+	QModbusDataBlockType getChangeCounterType() const;
+	void                 setChangeCounterType(const QModbusDataBlockType &changeCounterType);
+
+	// NOTE : -1 disables the change counter
+	int  getChangeCounterAddress() const;
+	void setChangeCounterAddress(const int &changeCounterAddress);
+
+	// NOTE : with a change counter, the block is read anyway at this interval (ms, 0 means never)
+	quint32 getMaxReadInterval() const;
+	void    setMaxReadInterval(const quint32 &maxReadInterval);
+
+	// NOTE : value of the same client that makes this block be read once, out of cycle, when triggered
+	//        e.g. "Block/Value", or just "Value" for a value of this block (empty disables)
+	QString getTriggerValue() const;
+	void    setTriggerValue(const QString &strTriggerValue);
+
+	QModbusTriggerMode getTriggerMode() const;
+	void               setTriggerMode(const QModbusTriggerMode &triggerMode);
+
+	// NOTE : blocks of the same client with the same read group are read back-to-back
+	//        and only updated if all reads succeed, all with the same source timestamp (empty disables)
+	//        the group is read at the sampling time of its first member, the others do not poll
+	QString getReadGroup() const;
+	void    setReadGroup(const QString &strReadGroup);
+
+	// NOTE : polls at multiples of the sampling time since the epoch (UTC), e.g. exactly on each second
+	bool getAlignToClock() const;
+	void setAlignToClock(const bool &alignToClock);
+
+	// NOTE : 0 means as fast as the client allows (MinSamplingTime of the client)
+	quint32 getBurstSamplingTime() const;
+	void    setBurstSamplingTime(const quint32 &burstSamplingTime);
+
+	// time (ms) polling at burst rate after a burst is triggered
+	quint32 getBurstDuration() const;
+	void    setBurstDuration(const quint32 &burstDuration);
+
+	// NOTE : last frames read at the sampling time, kept to be prepended to the next capture
+	quint32 getPreTriggerFrames() const;
+	void    setPreTriggerFrames(const quint32 &preTriggerFrames);
+
+	// NOTE : the trigger value starts a burst capture instead of a single read
+	bool getBurstOnTrigger() const;
+	void setBurstOnTrigger(const bool &burstOnTrigger);
+
+	bool isBurstActive() const;
+
+	QModbusPollMode getPollMode() const;
+	void            setPollMode(const QModbusPollMode &pollMode);
+
+	// NOTE : readNow does not read if the last successful read is not older than this (ms, 0 always reads)
+	quint32 getMaxAge() const;
+	void    setMaxAge(const quint32 &maxAge);
+
+	// NOTE : a disabled block is neither read nor written, but keeps its values and config
+	bool getEnabled() const;
+	void setEnabled(const bool &enabled);
+
+	// NOTE : mean and standard deviation (ms) of the time between polls, over the last second
+	double getAchievedPeriod() const;
+	double getPeriodJitter() const;
+
 	bool isWellConfigured() const;
 
 	QUaModbusDataBlockList * list() const;
@@ -110,55 +309,244 @@ public:
 
 signals:
 	// C++ API
-	void typeChanged        (const QModbusDataBlockType &type        );
-	void addressChanged     (const int                  &address     );
-	void sizeChanged        (const quint32              &size        );
-	void samplingTimeChanged(const quint32              &samplingTime);
-	void dataChanged        (const QVector<quint16>     &data        );
-	void lastErrorChanged   (const QModbusError         &error       );
+	void typeChanged         (const QModbusDataBlockType &type         );
+	void addressChanged      (const int                  &address      );
+	void sizeChanged         (const quint32              &size         );
+	void samplingTimeChanged (const quint32              &samplingTime );
+	void serverAddressChanged(const int                  &serverAddress);
+	void broadcastChanged    (const bool                 &broadcast    );
+	void readWriteMultipleChanged(const bool             &readWriteMultiple);
+	void readbackAfterWriteChanged(const bool            &readbackAfterWrite);
+	void dataChanged         (const QVector<quint16>     &data         );
+	void lastErrorChanged    (const QModbusError         &error        );
+	void quarantineIntervalChanged(const quint32         &quarantineInterval);
+	void quarantinedChanged  (const bool                 &quarantined  );
+	void changeCounterTypeChanged   (const QModbusDataBlockType &changeCounterType   );
+	void changeCounterAddressChanged(const int                  &changeCounterAddress);
+	void maxReadIntervalChanged     (const quint32              &maxReadInterval     );
+	void triggerValueChanged(const QString            &strTriggerValue);
+	void triggerModeChanged (const QModbusTriggerMode &triggerMode    );
+	void readGroupChanged   (const QString            &strReadGroup   );
+	void alignToClockChanged(const bool               &alignToClock   );
+	void burstSamplingTimeChanged(const quint32 &burstSamplingTime);
+	void burstDurationChanged    (const quint32 &burstDuration    );
+	void preTriggerFramesChanged (const quint32 &preTriggerFrames );
+	void burstOnTriggerChanged   (const bool    &burstOnTrigger   );
+	// a burst capture finished, retrieve it with burstCapture
+	void burstCaptured();
+	void pollModeChanged(const QModbusPollMode &pollMode);
+	void maxAgeChanged  (const quint32         &maxAge  );
+	void enabledChanged (const bool            &enabled );
+	// a read of the block finished (also periodic ones)
+	void readFinished(const QModbusError &error);
 
 	// (internal) to safely update error in ua server thread
 	void updateLastError(const QModbusError &error);
+	// (internal) to safely update poll timing in ua server thread
+	void updatePollTiming(const double &period, const double &jitter);
 	void aboutToDestroy();
 
 private slots:
 	// handle UA change events (also reused in C++ API and triggers C++ API events)
-	void on_typeChanged        (const QVariant     &value, const bool &networkChange);
-	void on_addressChanged     (const QVariant     &value, const bool &networkChange);
-	void on_sizeChanged        (const QVariant     &value, const bool &networkChange);
-	void on_samplingTimeChanged(const QVariant     &value, const bool &networkChange);
-	void on_dataChanged        (const QVariant     &value, const bool &networkChange);
-	void on_updateLastError    (const QModbusError &error);
+	void on_typeChanged         (const QVariant     &value, const bool &networkChange);
+	void on_addressChanged      (const QVariant     &value, const bool &networkChange);
+	void on_sizeChanged         (const QVariant     &value, const bool &networkChange);
+	void on_samplingTimeChanged (const QVariant     &value, const bool &networkChange);
+	void on_serverAddressChanged(const QVariant     &value, const bool &networkChange);
+	void on_broadcastChanged    (const QVariant     &value, const bool &networkChange);
+	void on_readWriteMultipleChanged(const QVariant &value, const bool &networkChange);
+	void on_readbackAfterWriteChanged(const QVariant &value, const bool &networkChange);
+	void on_quarantineIntervalChanged(const QVariant &value, const bool &networkChange);
+	void on_changeCounterTypeChanged   (const QVariant &value, const bool &networkChange);
+	void on_changeCounterAddressChanged(const QVariant &value, const bool &networkChange);
+	void on_maxReadIntervalChanged     (const QVariant &value, const bool &networkChange);
+	void on_triggerValueChanged(const QVariant &value, const bool &networkChange);
+	void on_triggerModeChanged (const QVariant &value, const bool &networkChange);
+	void on_readGroupChanged   (const QVariant &value, const bool &networkChange);
+	void on_alignToClockChanged(const QVariant &value, const bool &networkChange);
+	void on_burstSamplingTimeChanged(const QVariant &value, const bool &networkChange);
+	void on_burstDurationChanged    (const QVariant &value, const bool &networkChange);
+	void on_preTriggerFramesChanged (const QVariant &value, const bool &networkChange);
+	void on_burstOnTriggerChanged   (const QVariant &value, const bool &networkChange);
+	// burst duration elapsed
+	void on_burstTimeout();
+	void on_pollModeChanged(const QVariant &value, const bool &networkChange);
+	void on_maxAgeChanged  (const QVariant &value, const bool &networkChange);
+	void on_enabledChanged (const QVariant &value, const bool &networkChange);
+	// trigger value changed
+	void on_triggerUpdated(const QVariant &value);
+	void on_dataChanged         (const QVariant     &value, const bool &networkChange);
+	void on_updateLastError     (const QModbusError &error);
+	void on_updatePollTiming    (const double &period, const double &jitter);
 
 private:
 	int  m_loopHandle;
+	// NOTE : high rate loop, the timer lives in thread, running is cleared from ua server thread
+	struct QUaModbusPreciseLoop
+	{
+		QAtomicInt running = 1;
+		QTimer *   timer   = nullptr;
+	};
+	QSharedPointer<QUaModbusPreciseLoop> m_preciseLoop;
+	// NOTE : aligned loop, same as the high rate one but the single shot timer is armed for each boundary
+	struct QUaModbusAlignedLoop
+	{
+		QAtomicInt running = 1;
+		QTimer *   timer   = nullptr;
+		qint64     period  = 1;  // ms
+		qint64     next    = 0;  // ms since epoch, last boundary armed
+	};
+	QSharedPointer<QUaModbusAlignedLoop> m_alignedLoop;
 	bool m_firstSample;
-	QModbusReply  * m_replyRead;
+	// NOTE : replies are deleted with their modbus client (failover), handlers must not outlive them
+	QPointer<QModbusReply> m_replyRead;
+	QPointer<QModbusReply> m_replyCounter;
 	// NOTE : only modify and access in thread
 	QModbusDataBlockType m_registerType;
 	int                  m_startAddress;
 	quint32              m_valueCount;
+	int                  m_serverAddressOverride;
+	bool                 m_isBroadcast;
+	bool                 m_isWriteOnly;
+	bool                 m_isEnabled;
+	bool                 m_isReadWrite;
+	bool                 m_readWriteUnsupported;
+	bool                 m_readbackPending;
+	bool                 m_isQuarantined;
+	quint32              m_quarantineTime;
+	QElapsedTimer        m_quarantineProbe;
+	QModbusDataBlockType m_counterType;
+	int                  m_counterAddress;
+	int                  m_counterValue; // -1 if unknown
+	int                  m_counterPending; // -1 if none, moved but block not read yet
+	quint32              m_maxReadTime;
+	QElapsedTimer        m_lastRead;
+	QString              m_groupName;
+	bool                 m_isBursting;
+	QElapsedTimer        m_pollClock;
+	qint64               m_lastPoll;    // ns, -1 if none yet
+	qint64               m_lastPublish; // ns
+	double               m_pollNominal; // ms
+	quint64              m_pollCount;
+	double               m_pollSum;
+	double               m_pollSumSquares;
+	// NOTE : written in thread, read in ua server thread
+	mutable QMutex       m_timingMutex;
+	QVector<quint64>     m_jitterHistogram;
+	// NOTE : only modify and access in ua server thread
+	int                  m_exceptionCount;
+	QModbusExceptionCode m_lastException;
+	QPointer<QUaModbusValue> m_trigger;
+	QMetaObject::Connection  m_triggerConnection;
+	// NOTE : resolve again when the referenced block or value is added, renamed or removed
+	QList<QMetaObject::Connection> m_triggerWatch;
+	QVariant                 m_triggerLast;
+	struct QUaModbusFrame
+	{
+		QDateTime        timestamp;
+		QVector<quint16> data;
+	};
+	bool                  m_burstRunning;
+	QTimer                m_burstTimer;
+	QDateTime             m_burstTrigger;
+	QList<QUaModbusFrame> m_preTrigger;
+	QList<QUaModbusFrame> m_burstFrames;
+	QElapsedTimer         m_lastUpdate;
+	QMetaObject::Connection m_connectConnection;
 
 	void startLoop();
+	void stopLoop();
 	bool loopRunning();
+	// NOTE : only call in thread
+	void scheduleAlignedPoll(QUaModbusAlignedLoop * loop);
+	// NOTE : only call in thread
+	void poll();
+	void measurePollTiming();
+	void resetPollStats();
 	void setModbusData(const QVector<quint16>& data);
+	// read out of cycle (after a write or a trigger)
+	void readback();
+	// find and subscribe to the trigger value
+	bool resolveTrigger();
+	void logUnresolvedTrigger();
+	// keep a frame read for burst captures
+	void captureFrame(const QVector<quint16> &data, const QDateTime &timestamp);
+	// NOTE : only call in thread
+	quint8 requestServerAddress() const;
+	bool   useReadWrite(const int &writeCount) const;
+	void   enqueueRead(const QSharedPointer<QUaModbusGroupRead> &groupRead = QSharedPointer<QUaModbusGroupRead>(), const int &index = -1);
+	void   enqueueCounterRead();
+	// NOTE : only call in ua server thread, completes a read that will never be answered
+	void   abortRead(const QSharedPointer<QUaModbusGroupRead> &groupRead, const int &index, const QModbusError &error);
+	void   enqueueReadWrite(const QModbusDataUnit &dataToWrite, const std::function<void()> &written);
+	// update data and values with the result of a read
+	void   updateFromRead(const QVector<quint16> &data, const QModbusError &error, const QModbusExceptionCode &exceptionCode, const QDateTime &timestamp = QDateTime());
+	void   updateException(const QModbusError &error, const QModbusExceptionCode &exceptionCode);
+	static QModbusExceptionCode replyException(QModbusReply * reply);
+	// NOTE : only call in thread, right after sending, the time is taken in thread when the reply arrives
+	static QSharedPointer<QDateTime> replyTimestamp(QModbusReply * reply);
 
 	// XML import / export
 	QDomElement toDomElement  (QDomDocument & domDoc) const;
 	void        fromDomElement(QDomElement  & domElem, QQueue<QUaLog>& errorLogs);
 
 	static quint32 m_minSamplingTime;
+	static QVector<double> m_jitterBins;
+	static int     m_quarantineAfter;
 	static QVector<quint16> variantToInt16Vect(const QVariant &value);
 
 	QUaProperty* m_type;
 	QUaProperty* m_address;
 	QUaProperty* m_size;
 	QUaProperty* m_samplingTime;
+	QUaProperty* m_serverAddress;
+	QUaProperty* m_broadcast;
+	QUaProperty* m_readWriteMultiple;
+	QUaProperty* m_readbackAfterWrite;
+	QUaProperty* m_quarantineInterval;
+	QUaProperty* m_changeCounterType;
+	QUaProperty* m_changeCounterAddress;
+	QUaProperty* m_maxReadInterval;
+	QUaProperty* m_triggerValue;
+	QUaProperty* m_triggerMode;
+	QUaProperty* m_readGroup;
+	QUaProperty* m_alignToClock;
+	QUaProperty* m_burstSamplingTime;
+	QUaProperty* m_burstDuration;
+	QUaProperty* m_preTriggerFrames;
+	QUaProperty* m_burstOnTrigger;
+	QUaProperty* m_pollMode;
+	QUaProperty* m_maxAge;
+	QUaProperty* m_enabled;
 	QUaBaseDataVariable* m_data;
 	QUaBaseDataVariable* m_lastError;
+	QUaBaseDataVariable* m_exceptionCode;
+	QUaBaseDataVariable* m_quarantined;
+	QUaBaseDataVariable* m_achievedPeriod;
+	QUaBaseDataVariable* m_periodJitter;
+	QUaBaseDataVariable* m_burstActive;
 	QUaModbusValueList* m_values;
 };
 
 typedef QUaModbusDataBlock::RegisterType QModbusDataBlockType;
+typedef QUaModbusDataBlock::ExceptionCode QModbusExceptionCode;
+typedef QUaModbusDataBlock::TriggerMode QModbusTriggerMode;
+typedef QUaModbusDataBlock::PollMode QModbusPollMode;
+
+// NOTE : results of the reads of the blocks of a read group, committed when all are in
+struct QUaModbusGroupRead
+{
+	struct Result
+	{
+		QPointer<QUaModbusDataBlock> block;
+		QVector<quint16>             data;
+		QModbusError                 error         = QModbusError::ReplyAbortedError;
+		QModbusExceptionCode         exceptionCode = QModbusExceptionCode::NoException;
+		QDateTime                    timestamp;
+	};
+	QString       name;
+	int           pending = 0;
+	QList<Result> results;
+};
 
 #endif // QUAMODBUSDATABLOCK_H
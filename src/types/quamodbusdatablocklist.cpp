@@ -85,6 +85,160 @@ QList<QUaModbusDataBlock*> QUaModbusDataBlockList::blocks()
 	return this->browseChildren<QUaModbusDataBlock>();
 }
 
+void QUaModbusDataBlockList::startLoops()
+{
+	for (auto block : this->blocks())
+	{
+		if (block->loopRunning())
+		{
+			continue;
+		}
+		block->startLoop();
+	}
+}
+
+void QUaModbusDataBlockList::stopLoops()
+{
+	for (auto block : this->blocks())
+	{
+		block->stopLoop();
+	}
+}
+
+void QUaModbusDataBlockList::setGroupMember(QUaModbusDataBlock * block, const QString & strOldGroup, const QString & strNewGroup)
+{
+	if (!strOldGroup.isEmpty() && m_groupMembers.contains(strOldGroup))
+	{
+		auto &members = m_groupMembers[strOldGroup];
+		members.removeAll(block);
+		if (members.isEmpty())
+		{
+			m_groupMembers.remove(strOldGroup);
+		}
+	}
+	if (!strNewGroup.isEmpty())
+	{
+		m_groupMembers[strNewGroup].append(block);
+	}
+}
+
+QUaModbusDataBlock * QUaModbusDataBlockList::groupLeader(const QString & strReadGroup)
+{
+	auto &members = m_groupMembers[strReadGroup];
+	// deleted blocks are not removed explicitly
+	members.removeAll(QPointer<QUaModbusDataBlock>());
+	for (auto &block : members)
+	{
+		if (block->isWellConfigured() && block->m_isEnabled && !block->m_isBroadcast &&
+			!block->m_isWriteOnly && !block->m_isQuarantined && !block->m_isBursting)
+		{
+			return block;
+		}
+	}
+	return nullptr;
+}
+
+void QUaModbusDataBlockList::readGroup(const QString & strReadGroup)
+{
+	// previous read of the group still on its way
+	if (m_groupReads.value(strReadGroup).toStrongRef())
+	{
+		return;
+	}
+	auto groupRead = QSharedPointer<QUaModbusGroupRead>::create();
+	groupRead->name = strReadGroup;
+	auto scheduler = this->client()->m_scheduler;
+	QList<QUaModbusDataBlock*> members;
+	for (auto &block : m_groupMembers.value(strReadGroup))
+	{
+		if (!block || !block->isWellConfigured() || block->m_isBroadcast || block->m_isWriteOnly ||
+			!block->m_isEnabled || block->m_isQuarantined || block->m_isBursting || block->m_replyRead ||
+			scheduler->isQueued(block->requestServerAddress(), block, QUaModbusScheduler::Read))
+		{
+			continue;
+		}
+		// a dead server would fail the whole group, read it on its own so its breaker gets probed
+		if (scheduler->breakerState(block->requestServerAddress()) != QUaModbusScheduler::Closed)
+		{
+			block->enqueueRead();
+			continue;
+		}
+		QUaModbusGroupRead::Result result;
+		result.block = block;
+		groupRead->results << result;
+		members << block;
+	}
+	if (members.isEmpty())
+	{
+		return;
+	}
+	groupRead->pending = members.count();
+	m_groupReads[strReadGroup] = groupRead;
+	for (int i = 0; i < members.count(); i++)
+	{
+		members.at(i)->enqueueRead(groupRead, i);
+	}
+}
+
+void QUaModbusDataBlockList::updateGroupRead(
+	const QSharedPointer<QUaModbusGroupRead> &groupRead,
+	const int                                &index,
+	const QVector<quint16>                   &data,
+	const QModbusDevice::Error               &error,
+	const int                                &exceptionCode,
+	const QDateTime                          &timestamp/* = QDateTime()*/)
+{
+	Q_ASSERT(index >= 0 && index < groupRead->results.count());
+	auto &result = groupRead->results[index];
+	result.data          = data;
+	result.error         = error;
+	result.exceptionCode = static_cast<QModbusExceptionCode>(exceptionCode);
+	result.timestamp     = timestamp;
+	groupRead->pending--;
+	if (groupRead->pending > 0)
+	{
+		return;
+	}
+	// all or nothing, a partial snapshot would mix data of different moments
+	// NOTE : snapshot is taken when the last reply arrived (in thread)
+	bool isComplete = true;
+	auto groupError = QModbusDevice::NoError;
+	QDateTime snapshotTime;
+	for (auto &result : groupRead->results)
+	{
+		isComplete = isComplete && result.error == QModbusDevice::NoError;
+		if (groupError == QModbusDevice::NoError)
+		{
+			groupError = result.error;
+		}
+		if (result.timestamp.isValid() && (!snapshotTime.isValid() || result.timestamp > snapshotTime))
+		{
+			snapshotTime = result.timestamp;
+		}
+	}
+	for (auto &result : groupRead->results)
+	{
+		if (!result.block)
+		{
+			continue;
+		}
+		if (isComplete)
+		{
+			result.block->updateFromRead(result.data, result.error, result.exceptionCode, snapshotTime);
+		}
+		else if (result.error != QModbusDevice::NoError)
+		{
+			// only report the failing ones, the rest keep their last snapshot
+			result.block->updateFromRead(result.data, result.error, result.exceptionCode, result.timestamp);
+		}
+		else
+		{
+			// its read ended as well, without new data (readNow)
+			emit result.block->readFinished(groupError);
+		}
+	}
+}
+
 QDomElement QUaModbusDataBlockList::toDomElement(QDomDocument & domDoc) const
 {
 	// add block list element
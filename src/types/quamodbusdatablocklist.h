@@ -9,11 +9,18 @@
 
 #include <QDomDocument>
 #include <QDomElement>
+#include <QModbusDevice>
+#include <QSharedPointer>
+#include <QWeakPointer>
+#include <QPointer>
+#include <QMap>
+#include <QDateTime>
 
 class QUaModbusClient;
 class QUaModbusTcpClient;
 class QUaModbusRtuSerialClient;
 class QUaModbusDataBlock;
+struct QUaModbusGroupRead;
 
 #ifndef QUA_ACCESS_CONTROL
 class QUaModbusDataBlockList : public QUaFolderObject
@@ -45,8 +52,33 @@ signals:
 	void aboutToClear();
 
 private:
+	// NOTE : only use in thread, a group is being read while someone holds its reads
+	QMap<QString, QWeakPointer<QUaModbusGroupRead>> m_groupReads;
+	// NOTE : only use in thread, members of each group in the order they joined it
+	QMap<QString, QList<QPointer<QUaModbusDataBlock>>> m_groupMembers;
+
 	QUaModbusClient * client();
 
+	// NOTE : only call in ua server thread, e.g. when the client is enabled or disabled
+	void startLoops();
+	void stopLoops();
+
+	// NOTE : only call in thread, moves a block from a group to another (empty means none)
+	void setGroupMember(QUaModbusDataBlock * block, const QString &strOldGroup, const QString &strNewGroup);
+	// NOTE : only call in thread, the member whose loop reads the group, nullptr if none can
+	QUaModbusDataBlock * groupLeader(const QString &strReadGroup);
+	// NOTE : only call in thread, reads all the blocks of the group unless already reading it
+	void readGroup(const QString &strReadGroup);
+	// NOTE : only call in ua server thread, commits the group when all reads are in
+	void updateGroupRead(
+		const QSharedPointer<QUaModbusGroupRead> &groupRead,
+		const int                                &index,
+		const QVector<quint16>                   &data,
+		const QModbusDevice::Error               &error,
+		const int                                &exceptionCode,
+		const QDateTime                          &timestamp = QDateTime()
+	);
+
 	// XML import / export
 	QDomElement toDomElement  (QDomDocument & domDoc) const;
 	void        fromDomElement(QDomElement  & domElem, QQueue<QUaLog>& errorLogs);
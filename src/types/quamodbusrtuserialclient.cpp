@@ -1,6 +1,7 @@
 #include "quamodbusrtuserialclient.h"
 
 #include <QSerialPortInfo>
+#include <QtMath>
 
 #ifdef QUA_ACCESS_CONTROL
 #include <QUaPermissions>
@@ -9,6 +10,7 @@
 QUaModbusRtuSerialClient::QUaModbusRtuSerialClient(QUaServer *server)
 	: QUaModbusClient(server)
 {
+	m_loopHandle = -1;
 	// set defaults
 	type    ()->setDataTypeEnum(QMetaEnum::fromType<QModbusClientType>());
 	type    ()->setValue(QModbusClientType::Serial);
@@ -22,12 +24,17 @@ QUaModbusRtuSerialClient::QUaModbusRtuSerialClient(QUaServer *server)
 	dataBits()->setValue(QSerialPort::Data8);
 	stopBits()->setDataTypeEnum(QMetaEnum::fromType<QStopBits>());
 	stopBits()->setValue(QSerialPort::OneStop);
+	slaveDelays   ()->setDataType(QMetaType::QString);
+	slaveDelays   ()->setValue("");
+	busUtilization()->setDataType(QMetaType::Double);
+	busUtilization()->setValue(0.0);
 	// set initial conditions
 	comPort ()->setWriteAccess(true);
 	parity  ()->setWriteAccess(true);
 	baudRate()->setWriteAccess(true);
 	dataBits()->setWriteAccess(true);
 	stopBits()->setWriteAccess(true);
+	slaveDelays()->setWriteAccess(true);
 	// instantiate client
 	this->resetModbusClient();
 	// handle state changes
@@ -36,6 +43,13 @@ QUaModbusRtuSerialClient::QUaModbusRtuSerialClient(QUaServer *server)
 	QObject::connect(baudRate(), &QUaBaseVariable::valueChanged, this, &QUaModbusRtuSerialClient::on_baudRateChanged, Qt::QueuedConnection);
 	QObject::connect(dataBits(), &QUaBaseVariable::valueChanged, this, &QUaModbusRtuSerialClient::on_dataBitsChanged, Qt::QueuedConnection);
 	QObject::connect(stopBits(), &QUaBaseVariable::valueChanged, this, &QUaModbusRtuSerialClient::on_stopBitsChanged, Qt::QueuedConnection);
+	QObject::connect(slaveDelays(), &QUaBaseVariable::valueChanged, this, &QUaModbusRtuSerialClient::on_slaveDelaysChanged, Qt::QueuedConnection);
+	// to safely update bus utilization in ua server thread
+	QObject::connect(this, &QUaModbusRtuSerialClient::updateBusUtilization, this, &QUaModbusRtuSerialClient::on_updateBusUtilization);
+	// measure bus utilization every second
+	m_loopHandle = m_workerThread.startLoopInThread([this]() {
+		emit this->updateBusUtilization(m_scheduler->takeBusUtilization());
+	}, 1000);
 	// set descriptions
 	/*
 	comPort ()->setDescription("Local serial COM port used to connect to the Modbus server.");
@@ -43,9 +57,21 @@ QUaModbusRtuSerialClient::QUaModbusRtuSerialClient(QUaServer *server)
 	baudRate()->setDescription("Baud Rate value (data rate in bits per second) used to communicate with the Modbus server.");
 	dataBits()->setDescription("Number of Data Bits (in each character) used to communicate with the Modbus server.");
 	stopBits()->setDescription("Number of Stop Bits (sent at the end of every character) used to communicate with the Modbus server.");
+	slaveDelays()->setDescription("Silent time in ms to keep on the bus before addressing each Modbus server, e.g. 1:10,7:25.");
+	busUtilization()->setDescription("Percentage of time the bus carried Modbus frames during the last second.");
 	*/
 }
 
+QUaModbusRtuSerialClient::~QUaModbusRtuSerialClient()
+{
+	// stop loop before anything else is destroyed
+	if (m_loopHandle > 0)
+	{
+		m_workerThread.stopLoopInThread(m_loopHandle);
+	}
+	m_loopHandle = -1;
+}
+
 QUaProperty * QUaModbusRtuSerialClient::comPort() const
 {
 	QMutexLocker locker(&(const_cast<QUaModbusRtuSerialClient*>(this)->m_mutex));
@@ -76,6 +102,81 @@ QUaProperty * QUaModbusRtuSerialClient::stopBits() const
 	return const_cast<QUaModbusRtuSerialClient*>(this)->browseChild<QUaProperty>("StopBits");
 }
 
+QUaProperty * QUaModbusRtuSerialClient::slaveDelays() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusRtuSerialClient*>(this)->m_mutex));
+	return const_cast<QUaModbusRtuSerialClient*>(this)->browseChild<QUaProperty>("SlaveDelays");
+}
+
+QUaBaseDataVariable * QUaModbusRtuSerialClient::busUtilization() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusRtuSerialClient*>(this)->m_mutex));
+	return const_cast<QUaModbusRtuSerialClient*>(this)->browseChild<QUaBaseDataVariable>("BusUtilization");
+}
+
+QString QUaModbusRtuSerialClient::broadcastWriteRegisters(const int & address, const QString & strValues)
+{
+	return this->broadcastWrite(QModbusDataUnit::HoldingRegisters, address, strValues);
+}
+
+QString QUaModbusRtuSerialClient::broadcastWriteCoils(const int & address, const QString & strValues)
+{
+	return this->broadcastWrite(QModbusDataUnit::Coils, address, strValues);
+}
+
+QString QUaModbusRtuSerialClient::broadcastWrite(const QModbusDataUnit::RegisterType & type, const int & address, const QString & strValues)
+{
+	if (this->getState() != QModbusState::ConnectedState)
+	{
+		return tr("%1 : Client is not connected.").arg("Error");
+	}
+	if (address < 0 || address > 65535)
+	{
+		return tr("%1 : Invalid address %2.").arg("Error").arg(address);
+	}
+	// parse values
+	bool isCoils = type == QModbusDataUnit::Coils;
+	QVector<quint16> data;
+	auto listValues = strValues.split(",", QString::SkipEmptyParts);
+	for (auto strValue : listValues)
+	{
+		bool ok;
+		auto value = strValue.trimmed().toUInt(&ok);
+		if (!ok || value > (isCoils ? 1u : 65535u))
+		{
+			return tr("%1 : Invalid value '%2'.").arg("Error").arg(strValue.trimmed());
+		}
+		data << static_cast<quint16>(value);
+	}
+	// modbus limits the size of a single write
+	int maxCount = isCoils ? 1968 : 123;
+	if (data.isEmpty() || data.count() > maxCount || address + data.count() > 65536)
+	{
+		return tr("%1 : Number of values must be between 1 and %2.").arg("Error").arg(maxCount);
+	}
+	QModbusDataUnit dataToWrite(type, address, data);
+	// exec write request in client thread
+	m_workerThread.execInThread([this, dataToWrite]() {
+		m_scheduler->enqueue(0, this, QUaModbusScheduler::Write,
+		[this, dataToWrite]() -> QModbusReply* {
+			QModbusReply * p_reply = m_modbusClient->sendWriteRequest(dataToWrite, 0);
+			if (!p_reply)
+			{
+				return nullptr;
+			}
+			// usually finished immediately, else wait for the turnaround delay to elapse
+			if (p_reply->isFinished())
+			{
+				p_reply->deleteLater();
+				return nullptr;
+			}
+			QObject::connect(p_reply, &QModbusReply::finished, p_reply, &QObject::deleteLater);
+			return p_reply;
+		}, QUaModbusScheduler::writeRequestSize(dataToWrite.registerType(), dataToWrite.valueCount()));
+	});
+	return "Success";
+}
+
 QString QUaModbusRtuSerialClient::ComPorts = "QUaModbusRtuSerialClient::ComPorts";
 
 QUaEnumMap QUaModbusRtuSerialClient::EnumComPorts()
@@ -108,6 +209,10 @@ void QUaModbusRtuSerialClient::resetModbusClient()
 		m_modbusClient->setConnectionParameter(QModbusDevice::SerialBaudRateParameter, this->getBaudRate());
 		m_modbusClient->setConnectionParameter(QModbusDevice::SerialDataBitsParameter, this->getDataBits());
 		m_modbusClient->setConnectionParameter(QModbusDevice::SerialStopBitsParameter, this->getStopBits());
+		// only one frame on the bus at a time, so the scheduler decides who goes next
+		m_scheduler->setMaxInFlight(1);
+		m_scheduler->setSlaveDelays(QUaModbusRtuSerialClient::parseSlaveDelays(this->getSlaveDelays()));
+		this->updateSerialTiming();
 		// setup client (call base class method)
 		this->QUaModbusClient::resetModbusClient();
 		QObject::connect(m_modbusClient.data(), &QModbusClient::stateChanged, this, &QUaModbusRtuSerialClient::on_stateChanged, Qt::QueuedConnection);
@@ -129,11 +234,13 @@ QDomElement QUaModbusRtuSerialClient::toDomElement(QDomDocument & domDoc) const
 	elemSerialClient.setAttribute("BrowseName"    , this->browseName()  );
 	elemSerialClient.setAttribute("ServerAddress" , getServerAddress()  );
 	elemSerialClient.setAttribute("KeepConnecting", getKeepConnecting() );
+	this->toDomElementCommon(elemSerialClient);
 	elemSerialClient.setAttribute("ComPort"       , QString(QUaModbusRtuSerialClient::EnumComPorts().value(getComPortKey()).displayName.text()));
 	elemSerialClient.setAttribute("Parity"        , QMetaEnum::fromType<QParity>  ().valueToKey(getParity()   ));
 	elemSerialClient.setAttribute("BaudRate"      , QMetaEnum::fromType<QBaudRate>().valueToKey(getBaudRate() ));
 	elemSerialClient.setAttribute("DataBits"      , QMetaEnum::fromType<QDataBits>().valueToKey(getDataBits() ));
 	elemSerialClient.setAttribute("StopBits"      , QMetaEnum::fromType<QStopBits>().valueToKey(getStopBits() ));
+	elemSerialClient.setAttribute("SlaveDelays"   , getSlaveDelays());
 	// add block list element
 	auto elemBlockList = const_cast<QUaModbusRtuSerialClient*>(this)->dataBlocks()->toDomElement(domDoc);
 	elemSerialClient.appendChild(elemBlockList);
@@ -190,6 +297,8 @@ void QUaModbusRtuSerialClient::fromDomElement(QDomElement & domElem, QQueue<QUaL
 			QUaLogCategory::Serialization
 		);
 	}
+	// attributes common to all clients
+	this->fromDomElementCommon(domElem, errorLogs);
 	// ComPort
 	auto comPort = domElem.attribute("ComPort");
 	if (!comPort.isEmpty())
@@ -268,6 +377,24 @@ void QUaModbusRtuSerialClient::fromDomElement(QDomElement & domElem, QQueue<QUaL
 			QUaLogCategory::Serialization
 		);
 	}
+	// SlaveDelays (optional)
+	if (domElem.hasAttribute("SlaveDelays"))
+	{
+		auto strSlaveDelays = domElem.attribute("SlaveDelays");
+		QUaModbusRtuSerialClient::parseSlaveDelays(strSlaveDelays, &bOK);
+		if (bOK)
+		{
+			this->setSlaveDelays(strSlaveDelays);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid SlaveDelays attribute '%1' in Modbus client %2. Default value set.").arg(strSlaveDelays).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
 	// get block list
 	QDomElement elemBlockList = domElem.firstChildElement(QUaModbusDataBlockList::staticMetaObject.className());
 	if (!elemBlockList.isNull())
@@ -286,6 +413,13 @@ void QUaModbusRtuSerialClient::fromDomElement(QDomElement & domElem, QQueue<QUaL
 
 void QUaModbusRtuSerialClient::on_stateChanged(const QModbusDevice::State &state)
 {
+	// serial params only take effect on connection
+	if (state == QModbusDevice::State::ConnectingState)
+	{
+		m_workerThread.execInThread([this]() {
+			this->updateSerialTiming();
+		});
+	}
 	// only allow to write connection params if not connected
 	if (state == QModbusDevice::State::UnconnectedState)
 	{
@@ -305,6 +439,130 @@ void QUaModbusRtuSerialClient::on_stateChanged(const QModbusDevice::State &state
 	}
 }
 
+void QUaModbusRtuSerialClient::on_slaveDelaysChanged(const QVariant & value)
+{
+	QString strSlaveDelays = value.toString();
+	bool ok;
+	auto slaveDelays = QUaModbusRtuSerialClient::parseSlaveDelays(strSlaveDelays, &ok);
+	if (!ok)
+	{
+		// keep the valid part only
+		QStringList listDelays;
+		for (auto it = slaveDelays.begin(); it != slaveDelays.end(); ++it)
+		{
+			listDelays << QString("%1:%2").arg(it.key()).arg(it.value());
+		}
+		strSlaveDelays = listDelays.join(",");
+		this->slaveDelays()->setValue(strSlaveDelays);
+	}
+	// set in thread, for thread-safety
+	m_workerThread.execInThread([this, slaveDelays]() {
+		m_scheduler->setSlaveDelays(slaveDelays);
+	});
+	// emit
+	emit this->slaveDelaysChanged(strSlaveDelays);
+}
+
+void QUaModbusRtuSerialClient::on_updateBusUtilization(const double & busUtilization)
+{
+	this->busUtilization()->setValue(busUtilization);
+}
+
+void QUaModbusRtuSerialClient::updateSerialTiming()
+{
+	double charTime;
+	double interFrameTime;
+	if (!this->serialTiming(charTime, interFrameTime))
+	{
+		return;
+	}
+	m_scheduler->setCharTime(charTime);
+	m_scheduler->setInterFrameTime(interFrameTime);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 13, 0)
+	// default assumes 11 bits per character, use the actual frame format instead
+	auto serialMaster = qobject_cast<QModbusRtuSerialMaster*>(m_modbusClient.data());
+	if (serialMaster)
+	{
+		serialMaster->setInterFrameDelay(qCeil(interFrameTime));
+	}
+#endif
+}
+
+bool QUaModbusRtuSerialClient::serialTiming(double & charTime, double & interFrameTime) const
+{
+	auto baudRate = static_cast<double>(this->getBaudRate());
+	if (baudRate <= 0.0)
+	{
+		return false;
+	}
+	// bits per character : start, data, parity and stop
+	double bits = 1.0 + static_cast<double>(this->getDataBits());
+	bits += this->getParity() == QSerialPort::NoParity ? 0.0 : 1.0;
+	switch (this->getStopBits())
+	{
+	case QSerialPort::OneAndHalfStop:
+		bits += 1.5;
+		break;
+	case QSerialPort::TwoStop:
+		bits += 2.0;
+		break;
+	default:
+		bits += 1.0;
+		break;
+	}
+	charTime = 1000000.0 * bits / baudRate;
+	// modbus spec : fixed t1.5 and t3.5 above 19200 baud
+	// NOTE : t1.5 (inter character timeout) is handled by the serial port
+	interFrameTime = baudRate > 19200.0 ? 1750.0 : 3.5 * charTime;
+	return true;
+}
+
+double QUaModbusRtuSerialClient::expectedTransactionTime(const quint8 & serverAddress, const int & requestSize, const int & responseSize) const
+{
+	double charTime;
+	double interFrameTime;
+	if (!this->serialTiming(charTime, interFrameTime))
+	{
+		return -1.0;
+	}
+	// frames and the silent interval after each, in ms
+	double transactionTime = ((requestSize + responseSize) * charTime + 2.0 * interFrameTime) / 1000.0;
+	// plus what the server takes to answer (if measured) and the configured delay
+	if (m_scheduler)
+	{
+		auto stats = m_scheduler->slaveStats();
+		transactionTime += stats.value(serverAddress).turnaroundTime;
+	}
+	transactionTime += QUaModbusRtuSerialClient::parseSlaveDelays(this->getSlaveDelays()).value(serverAddress, 0);
+	return transactionTime;
+}
+
+QMap<quint8, int> QUaModbusRtuSerialClient::parseSlaveDelays(const QString & strSlaveDelays, bool * ok)
+{
+	QMap<quint8, int> slaveDelays;
+	bool allOk = true;
+	auto listDelays = strSlaveDelays.split(",", QString::SkipEmptyParts);
+	for (auto strDelay : listDelays)
+	{
+		auto listPair = strDelay.split(":");
+		bool addrOk  = false;
+		bool delayOk = false;
+		auto serverAddress = listPair.count() == 2 ? listPair.at(0).trimmed().toUInt(&addrOk ) : 0;
+		auto delay         = listPair.count() == 2 ? listPair.at(1).trimmed().toInt (&delayOk) : 0;
+		if (!addrOk || !delayOk || serverAddress > 255 || delay < 0)
+		{
+			allOk = false;
+			continue;
+		}
+		slaveDelays[static_cast<quint8>(serverAddress)] = delay;
+	}
+	if (ok)
+	{
+		*ok = allOk;
+	}
+	return slaveDelays;
+}
+
 void QUaModbusRtuSerialClient::on_comPortChanged(const QVariant & value)
 {
 	// NOTE : if connected, will not change until reconnect
@@ -448,3 +706,22 @@ void QUaModbusRtuSerialClient::setStopBits(const QStopBits & stopBits)
 	this->stopBits()->setValue(stopBits);
 	this->on_stopBitsChanged(stopBits);
 }
+
+QString QUaModbusRtuSerialClient::getSlaveDelays() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusRtuSerialClient*>(this)->m_mutex));
+	return this->slaveDelays()->value().toString();
+}
+
+void QUaModbusRtuSerialClient::setSlaveDelays(const QString & strSlaveDelays)
+{
+	QMutexLocker locker(&m_mutex);
+	this->slaveDelays()->setValue(strSlaveDelays);
+	this->on_slaveDelaysChanged(strSlaveDelays);
+}
+
+double QUaModbusRtuSerialClient::getBusUtilization() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusRtuSerialClient*>(this)->m_mutex));
+	return this->busUtilization()->value().toDouble();
+}
@@ -24,9 +24,14 @@ class QUaModbusRtuSerialClient : public QUaModbusClient
 	Q_PROPERTY(QUaProperty * BaudRate READ baudRate)
 	Q_PROPERTY(QUaProperty * DataBits READ dataBits)
 	Q_PROPERTY(QUaProperty * StopBits READ stopBits)
+	Q_PROPERTY(QUaProperty * SlaveDelays READ slaveDelays)
+
+	// UA variables
+	Q_PROPERTY(QUaBaseDataVariable * BusUtilization READ busUtilization)
 
 public:
 	Q_INVOKABLE explicit QUaModbusRtuSerialClient(QUaServer *server);
+	~QUaModbusRtuSerialClient();
 
 	// UA properties
 
@@ -35,6 +40,18 @@ public:
 	QUaProperty * baudRate() const;
 	QUaProperty * dataBits() const;
 	QUaProperty * stopBits() const;
+	QUaProperty * slaveDelays() const;
+
+	// UA variables
+
+	QUaBaseDataVariable * busUtilization() const;
+
+	// UA methods
+
+	// write to all servers at once (unit id 0), values are comma separated
+	// NOTE : there is no reply, so success only means the frame was queued
+	Q_INVOKABLE QString broadcastWriteRegisters(const int &address, const QString &strValues);
+	Q_INVOKABLE QString broadcastWriteCoils    (const int &address, const QString &strValues);
 
 	static QString ComPorts;
 	static QUaEnumMap EnumComPorts();
@@ -59,6 +76,12 @@ public:
 	QStopBits getStopBits() const;
 	void      setStopBits(const QStopBits &stopBits);
 
+	// NOTE : silence in ms before addressing a server, e.g. "1:10,7:25"
+	QString   getSlaveDelays() const;
+	void      setSlaveDelays(const QString &strSlaveDelays);
+
+	double    getBusUtilization() const;
+
 signals:
 	// C++ API
 	void comPortChanged (const QString   &strComPort);
@@ -66,9 +89,14 @@ signals:
 	void baudRateChanged(const QBaudRate &baudRate  );
 	void dataBitsChanged(const QDataBits &dataBits  );
 	void stopBitsChanged(const QStopBits &stopBits  );
+	void slaveDelaysChanged(const QString &strSlaveDelays);
+
+	// (internal) to safely update bus utilization in ua server thread
+	void updateBusUtilization(const double &busUtilization);
 
 protected:
 	void resetModbusClient() override;
+	double expectedTransactionTime(const quint8 &serverAddress, const int &requestSize, const int &responseSize) const override;
 	// XML import / export
 	QDomElement toDomElement  (QDomDocument & domDoc) const override;
 	void        fromDomElement(QDomElement  & domElem, QQueue<QUaLog>& errorLogs) override;
@@ -79,8 +107,19 @@ private slots:
 	void on_baudRateChanged(const QVariant &value);
 	void on_dataBitsChanged(const QVariant &value);
 	void on_stopBitsChanged(const QVariant &value);
+	void on_slaveDelaysChanged(const QVariant &value);
 	// internal
 	void on_stateChanged   (const QModbusDevice::State &state);
+	void on_updateBusUtilization(const double &busUtilization);
+
+private:
+	int m_loopHandle;
+	QString broadcastWrite(const QModbusDataUnit::RegisterType &type, const int &address, const QString &strValues);
+	// NOTE : only call in thread
+	void updateSerialTiming();
+	// character and inter-frame (t3.5) times in us for the configured serial params
+	bool serialTiming(double &charTime, double &interFrameTime) const;
+	static QMap<quint8, int> parseSlaveDelays(const QString &strSlaveDelays, bool *ok = nullptr);
 };
 
 #endif // QUAMODBUSRTUSERIALCLIENT_H
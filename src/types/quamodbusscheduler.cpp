@@ -0,0 +1,647 @@
+#include "quamodbusscheduler.h"
+
+#include <QMutexLocker>
+#include <QTimer>
+
+// bus time (ms) credited to each server on every round
+double QUaModbusScheduler::m_quantum = 50.0;
+// lower bound (ms) of the adaptive timeout, fast devices still get some slack
+double QUaModbusScheduler::m_minTimeout = 20.0;
+
+QUaModbusScheduler::QUaModbusScheduler(QObject *parent)
+	: QObject(parent)
+{
+	m_maxInFlight    = 1;
+	m_inFlight       = 0;
+	m_lastServed     = -1;
+	m_generation     = 0;
+	m_breakerThreshold = 3;
+	m_probeInterval  = 5000;
+	m_probePending   = false;
+	m_delayPending   = false;
+	m_charTime       = 0.0;
+	m_interFrameTime = 0.0;
+	m_frameTime      = 0.0;
+	m_timeout        = 1000;
+	m_adaptive       = false;
+	m_srtt           = -1.0;
+	m_rttvar         = 0.0;
+	m_rto            = 1000.0;
+	m_lastFinish     = 0;
+	m_lastTake       = 0;
+	m_clock.start();
+}
+
+int QUaModbusScheduler::maxInFlight() const
+{
+	return m_maxInFlight;
+}
+
+void QUaModbusScheduler::setMaxInFlight(const int & maxInFlight)
+{
+	m_maxInFlight = maxInFlight;
+	this->dispatch();
+}
+
+int QUaModbusScheduler::breakerThreshold() const
+{
+	return m_breakerThreshold;
+}
+
+void QUaModbusScheduler::setBreakerThreshold(const int & breakerThreshold)
+{
+	m_breakerThreshold = breakerThreshold;
+}
+
+int QUaModbusScheduler::probeInterval() const
+{
+	return m_probeInterval;
+}
+
+void QUaModbusScheduler::setProbeInterval(const int & probeInterval)
+{
+	m_probeInterval = probeInterval;
+}
+
+QUaModbusScheduler::BreakerState QUaModbusScheduler::breakerState(const quint8 & serverAddress) const
+{
+	return m_queues.value(serverAddress).breaker;
+}
+
+void QUaModbusScheduler::setCharTime(const double & charTime)
+{
+	m_charTime = charTime;
+}
+
+void QUaModbusScheduler::setInterFrameTime(const double & interFrameTime)
+{
+	m_interFrameTime = interFrameTime;
+}
+
+void QUaModbusScheduler::setSlaveDelays(const QMap<quint8, int>& slaveDelays)
+{
+	m_slaveDelays = slaveDelays;
+}
+
+void QUaModbusScheduler::setTimeout(const int & timeout, const bool & adaptive)
+{
+	auto oldTimeout = this->timeout();
+	m_timeout  = timeout;
+	m_adaptive = adaptive;
+	m_rto      = m_srtt < 0.0 ? timeout : qMin((double)timeout, m_rto);
+	if (this->timeout() != oldTimeout)
+	{
+		emit this->timeoutChanged(this->timeout());
+	}
+}
+
+int QUaModbusScheduler::timeout() const
+{
+	return m_adaptive ? qRound(m_rto) : m_timeout;
+}
+
+double QUaModbusScheduler::takeBusUtilization()
+{
+	auto now     = m_clock.elapsed();
+	auto elapsed = now - m_lastTake;
+	double utilization = elapsed > 0 ? qMin(100.0, m_frameTime / (10.0 * elapsed)) : 0.0;
+	m_frameTime = 0.0;
+	m_lastTake  = now;
+	return utilization;
+}
+
+int QUaModbusScheduler::writeRequestSize(const QModbusDataUnit::RegisterType & type, const int & count)
+{
+	// address, function, start, count, byte count, data, crc
+	int dataSize = type == QModbusDataUnit::Coils ? (count + 7) / 8 : 2 * count;
+	return 9 + dataSize;
+}
+
+bool QUaModbusScheduler::enqueue(
+	const quint8            &serverAddress,
+	QObject                 *owner,
+	const RequestKind       &kind,
+	const QUaModbusSendFunc &send,
+	const int               &requestSize)
+{
+	QUaModbusRequest request = { owner, kind, send, requestSize, serverAddress, m_clock.nsecsElapsed() };
+	// writes go in the priority lane
+	if (kind == RequestKind::Write)
+	{
+		m_writes.enqueue(request);
+		this->dispatch();
+		return true;
+	}
+	// group reads are not coalesced, the group is not read again until complete
+	// NOTE : a read of the block and a group read of the block would share its reply
+	if (kind == RequestKind::GroupRead)
+	{
+		if (this->isQueued(serverAddress, owner, RequestKind::Read))
+		{
+			return false;
+		}
+		m_groupReads.enqueue(request);
+		this->dispatch();
+		return true;
+	}
+	// standby reads have their own lane, they are not sent to the active endpoint
+	if (kind == RequestKind::Standby)
+	{
+		for (auto &queued : m_standbyReads)
+		{
+			if (queued.owner == owner)
+			{
+				return false;
+			}
+		}
+		m_standbyReads.enqueue(request);
+		this->dispatch();
+		return true;
+	}
+	// the group read reads the block as well
+	if (kind == RequestKind::Read && this->isQueued(serverAddress, owner, RequestKind::GroupRead))
+	{
+		return false;
+	}
+	auto &queue = m_queues[serverAddress];
+	// coalesce reads, no point in reading twice the same
+	// NOTE : a change counter read is not a read of the block, it cannot replace one
+	for (auto &queued : queue.requests)
+	{
+		if (queued.owner == owner && queued.kind == kind)
+		{
+			return false;
+		}
+	}
+	queue.requests.enqueue(request);
+	this->dispatch();
+	return true;
+}
+
+bool QUaModbusScheduler::isQueued(const quint8 & serverAddress, QObject * owner, const RequestKind & kind) const
+{
+	const QQueue<QUaModbusRequest> &requests =
+		kind == RequestKind::Write     ? m_writes       :
+		kind == RequestKind::GroupRead ? m_groupReads   :
+		kind == RequestKind::Standby   ? m_standbyReads :
+		m_queues.value(serverAddress).requests;
+	for (auto &queued : requests)
+	{
+		if (queued.owner == owner && queued.kind == kind)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void QUaModbusScheduler::clear()
+{
+	// start over with closed breakers
+	for (auto it = m_queues.begin(); it != m_queues.end(); ++it)
+	{
+		this->setBreaker(it.key(), BreakerState::Closed);
+	}
+	m_queues.clear();
+	m_writes.clear();
+	m_groupReads.clear();
+	m_standbyReads.clear();
+	m_inFlight   = 0;
+	m_lastServed = -1;
+	// ignore replies of the old modbus client if they ever finish
+	m_generation++;
+}
+
+void QUaModbusScheduler::abandonInFlight()
+{
+	// probes in flight will never be answered, probe again next interval
+	for (auto it = m_queues.begin(); it != m_queues.end(); ++it)
+	{
+		if (it.value().breaker == BreakerState::HalfOpen)
+		{
+			this->setBreaker(it.key(), BreakerState::Open);
+		}
+	}
+	m_inFlight = 0;
+	// ignore replies of the old modbus client if they ever finish
+	m_generation++;
+	// queued requests go to the new modbus client
+	QTimer::singleShot(0, this, [this]() {
+		this->dispatch();
+	});
+}
+
+QMap<quint8, QUaModbusSlaveStats> QUaModbusScheduler::slaveStats() const
+{
+	QMutexLocker locker(&m_statsMutex);
+	return m_stats;
+}
+
+void QUaModbusScheduler::resetSlaveStats()
+{
+	QMutexLocker locker(&m_statsMutex);
+	// breaker state is not a statistic, keep it
+	for (auto &stats : m_stats)
+	{
+		auto breakerState = stats.breakerState;
+		stats = QUaModbusSlaveStats();
+		stats.breakerState = breakerState;
+	}
+}
+
+void QUaModbusScheduler::dispatch()
+{
+	while (m_maxInFlight <= 0 || m_inFlight < m_maxInFlight)
+	{
+		auto now = m_clock.elapsed();
+		// writes preempt any queued read, then group reads go back-to-back, then the rare standby reads
+		QQueue<QUaModbusRequest> * lane = nullptr;
+		int laneIndex = -1;
+		for (auto candidate : { &m_writes, &m_groupReads, &m_standbyReads })
+		{
+			laneIndex = this->nextInLane(*candidate, now);
+			if (laneIndex >= 0)
+			{
+				lane = candidate;
+				break;
+			}
+		}
+		// probes of open breakers are rare, so they go first when due
+		int serverAddress = lane ? lane->at(laneIndex).serverAddress : this->nextProbe(now);
+		if (serverAddress < 0)
+		{
+			serverAddress = this->nextHealthy(now);
+		}
+		if (serverAddress < 0)
+		{
+			return;
+		}
+		auto &queue  = m_queues[static_cast<quint8>(serverAddress)];
+		// some servers need the bus silent for a while before being addressed
+		auto delay = m_slaveDelays.value(static_cast<quint8>(serverAddress), 0) - (now - m_lastFinish);
+		if (delay > 0)
+		{
+			if (!lane && queue.breaker == BreakerState::Closed)
+			{
+				m_lastServed = serverAddress;
+			}
+			if (!m_delayPending)
+			{
+				m_delayPending = true;
+				QTimer::singleShot(static_cast<int>(delay), this, [this]() {
+					m_delayPending = false;
+					this->dispatch();
+				});
+			}
+			return;
+		}
+		if (lane)
+		{
+			auto request = lane->takeAt(laneIndex);
+			// owner might have been deleted while queued
+			if (!request.owner)
+			{
+				continue;
+			}
+			if (request.kind == RequestKind::Write)
+			{
+				auto queueTime = (double)(m_clock.nsecsElapsed() - request.enqueueTime) / 1000000.0;
+				this->updateQueueTime(request.serverAddress, queueTime);
+			}
+			// dead server, the request goes as its probe
+			if (request.kind != RequestKind::Standby && queue.breaker != BreakerState::Closed)
+			{
+				queue.lastProbe = now;
+				this->setBreaker(request.serverAddress, BreakerState::HalfOpen);
+			}
+			this->send(request.serverAddress, request);
+			continue;
+		}
+		auto request = queue.requests.dequeue();
+		bool isProbe = queue.breaker != BreakerState::Closed;
+		if (!isProbe)
+		{
+			queue.deficit -= queue.cost;
+			m_lastServed   = serverAddress;
+		}
+		// no credit is kept while idle
+		if (queue.requests.isEmpty())
+		{
+			queue.deficit = 0.0;
+		}
+		// owner might have been deleted while queued
+		if (!request.owner)
+		{
+			continue;
+		}
+		if (isProbe)
+		{
+			queue.lastProbe = now;
+			this->setBreaker(static_cast<quint8>(serverAddress), BreakerState::HalfOpen);
+		}
+		this->send(static_cast<quint8>(serverAddress), request);
+	}
+}
+
+int QUaModbusScheduler::nextInLane(const QQueue<QUaModbusRequest>& lane, const qint64 & now)
+{
+	for (int i = 0; i < lane.count(); i++)
+	{
+		// NOTE : standby reads go to another endpoint, the breaker is not theirs
+		if (lane.at(i).kind == RequestKind::Standby)
+		{
+			return i;
+		}
+		// a dead server would make every request of the lane wait out the timeout
+		// so its requests stay in the lane, in order, and only one goes as probe when due
+		auto queue = m_queues.value(lane.at(i).serverAddress);
+		if (queue.breaker == BreakerState::Closed ||
+			(queue.breaker == BreakerState::Open && queue.lastProbe + m_probeInterval <= now))
+		{
+			return i;
+		}
+	}
+	return -1;
+}
+
+bool QUaModbusScheduler::hasLaneRequest(const quint8 & serverAddress) const
+{
+	for (auto lane : { &m_writes, &m_groupReads })
+	{
+		for (auto &request : *lane)
+		{
+			if (request.serverAddress == serverAddress)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+int QUaModbusScheduler::nextHealthy(const qint64 & now)
+{
+	bool hasPending = false;
+	for (auto &queue : m_queues)
+	{
+		if (!queue.requests.isEmpty() && queue.breaker == BreakerState::Closed)
+		{
+			hasPending = true;
+			break;
+		}
+	}
+	if (!hasPending)
+	{
+		return -1;
+	}
+	// keep serving the last one while it has enough credit
+	auto it = m_lastServed < 0 ? m_queues.end() : m_queues.find(static_cast<quint8>(m_lastServed));
+	if (it != m_queues.end() &&
+		!it.value().requests.isEmpty() &&
+		it.value().breaker == BreakerState::Closed &&
+		it.value().deficit >= it.value().cost)
+	{
+		return it.key();
+	}
+	// else credit the next ones until one can afford its request
+	it = m_lastServed < 0 ? m_queues.begin() : m_queues.upperBound(static_cast<quint8>(m_lastServed));
+	forever
+	{
+		if (it == m_queues.end())
+		{
+			it = m_queues.begin();
+		}
+		auto &queue = it.value();
+		if (!queue.requests.isEmpty() && queue.breaker == BreakerState::Closed)
+		{
+			queue.deficit += QUaModbusScheduler::m_quantum;
+			if (queue.deficit >= queue.cost)
+			{
+				return it.key();
+			}
+		}
+		++it;
+	}
+}
+
+int QUaModbusScheduler::nextProbe(const qint64 & now)
+{
+	qint64 nextProbe = -1;
+	for (auto it = m_queues.begin(); it != m_queues.end(); ++it)
+	{
+		auto &queue = it.value();
+		// only one probe in flight (half open)
+		// NOTE : lanes send their own probes, but also need to be woken up for them
+		if (queue.breaker != BreakerState::Open ||
+			(queue.requests.isEmpty() && !this->hasLaneRequest(it.key())))
+		{
+			continue;
+		}
+		auto probeTime = queue.lastProbe + m_probeInterval;
+		if (probeTime <= now && !queue.requests.isEmpty())
+		{
+			return it.key();
+		}
+		nextProbe = nextProbe < 0 ? probeTime : qMin(nextProbe, probeTime);
+	}
+	// wake up when the next probe is due
+	if (nextProbe >= 0 && !m_probePending)
+	{
+		m_probePending = true;
+		QTimer::singleShot(static_cast<int>(nextProbe - now), this, [this]() {
+			m_probePending = false;
+			this->dispatch();
+		});
+	}
+	return -1;
+}
+
+void QUaModbusScheduler::setBreaker(const quint8 & serverAddress, const BreakerState & state)
+{
+	auto &queue = m_queues[serverAddress];
+	if (queue.breaker == state)
+	{
+		return;
+	}
+	queue.breaker = state;
+	{
+		QMutexLocker locker(&m_statsMutex);
+		m_stats[serverAddress].breakerState = state;
+	}
+	emit this->breakerStateChanged(serverAddress, state);
+}
+
+void QUaModbusScheduler::send(const quint8 & serverAddress, const QUaModbusRequest & request)
+{
+	QElapsedTimer timer;
+	timer.start();
+	QModbusReply * reply = request.send();
+	// standby reads go to another endpoint, they say nothing about the active one
+	bool isStandby = request.kind == RequestKind::Standby;
+	if (!isStandby)
+	{
+		QMutexLocker locker(&m_statsMutex);
+		m_stats[serverAddress].requests++;
+	}
+	// nothing to wait for (failed to send or broadcast)
+	if (!reply)
+	{
+		// probe never made it, try again next interval
+		if (!isStandby && m_queues.contains(serverAddress) && m_queues[serverAddress].breaker == BreakerState::HalfOpen)
+		{
+			this->setBreaker(serverAddress, BreakerState::Open);
+		}
+		return;
+	}
+	m_inFlight++;
+	auto generation = m_generation;
+	QObject::connect(reply, &QModbusReply::finished, this,
+	[this, reply, serverAddress, timer, generation, request, isStandby]() {
+		// NOTE : exec'd in worker thread, before owner handles the reply
+		if (generation != m_generation)
+		{
+			return;
+		}
+		m_inFlight--;
+		m_lastFinish = m_clock.elapsed();
+		// dispatch next in next event loop exec, avoid re-entering modbus client
+		QTimer::singleShot(0, this, [this]() {
+			this->dispatch();
+		});
+		if (isStandby)
+		{
+			return;
+		}
+		auto error        = reply->error();
+		auto responseTime = (double)timer.nsecsElapsed() / 1000000.0;
+		// address, pdu, crc
+		auto responseSize = error == QModbusError::TimeoutError ? 0 : reply->rawResult().size() + 3;
+		// a gateway in front of a dead server answers, but it is a failure all the same
+		bool failed = error == QModbusError::TimeoutError ||
+			(error == QModbusError::ProtocolError &&
+			 reply->rawResult().exceptionCode() == QModbusPdu::GatewayTargetDeviceFailedToRespond);
+		this->updateHealth(serverAddress, failed, responseTime);
+		this->updateStats (serverAddress, error, responseTime);
+		this->updateTiming(serverAddress, error, responseTime, request.requestSize, responseSize);
+		this->updateTimeout(error, responseTime);
+		if (error == QModbusError::TimeoutError)
+		{
+			emit this->requestTimedOut(serverAddress);
+		}
+	});
+}
+
+void QUaModbusScheduler::updateStats(const quint8 & serverAddress, const QModbusError & error, const double & responseTime)
+{
+	QMutexLocker locker(&m_statsMutex);
+	auto &stats = m_stats[serverAddress];
+	if (error == QModbusError::TimeoutError)
+	{
+		stats.timeouts++;
+		return;
+	}
+	if (error != QModbusError::NoError)
+	{
+		stats.errors++;
+	}
+	else
+	{
+		stats.responses++;
+	}
+	// exponentially weighted average, first sample initializes
+	stats.lastResponseTime = responseTime;
+	stats.avgResponseTime  = stats.responses + stats.errors <= 1 ?
+		responseTime : 0.875 * stats.avgResponseTime + 0.125 * responseTime;
+	stats.maxResponseTime  = qMax(stats.maxResponseTime, responseTime);
+}
+
+void QUaModbusScheduler::updateTimeout(const QModbusError & error, const double & responseTime)
+{
+	auto oldTimeout = this->timeout();
+	if (error == QModbusError::TimeoutError)
+	{
+		// back off until the next valid sample
+		m_rto = qMin((double)m_timeout, 2.0 * m_rto);
+	}
+	// NOTE : samples longer than the timeout include retries, they are ambiguous (Karn)
+	else if (error != QModbusError::ReplyAbortedError && responseTime <= m_rto)
+	{
+		if (m_srtt < 0.0)
+		{
+			m_srtt   = responseTime;
+			m_rttvar = responseTime / 2.0;
+		}
+		else
+		{
+			m_rttvar = 0.75  * m_rttvar + 0.25  * qAbs(m_srtt - responseTime);
+			m_srtt   = 0.875 * m_srtt   + 0.125 * responseTime;
+		}
+		m_rto = qBound(m_minTimeout, m_srtt + 4.0 * m_rttvar, (double)m_timeout);
+	}
+	if (this->timeout() != oldTimeout)
+	{
+		emit this->timeoutChanged(this->timeout());
+	}
+}
+
+void QUaModbusScheduler::updateQueueTime(const quint8 & serverAddress, const double & queueTime)
+{
+	{
+		QMutexLocker locker(&m_statsMutex);
+		auto &stats = m_stats[serverAddress];
+		stats.writeQueueTime    = stats.writeQueueTime <= 0.0 ?
+			queueTime : 0.875 * stats.writeQueueTime + 0.125 * queueTime;
+		stats.maxWriteQueueTime = qMax(stats.maxWriteQueueTime, queueTime);
+	}
+	emit this->writeDispatched(queueTime);
+}
+
+void QUaModbusScheduler::updateHealth(const quint8 & serverAddress, const bool & failed, const double & responseTime)
+{
+	auto &queue = m_queues[serverAddress];
+	// cost is the bus time the server usually takes, a timeout costs the whole wait
+	queue.cost = 0.875 * queue.cost + 0.125 * qMax(1.0, responseTime);
+	if (!failed)
+	{
+		// any answer closes the breaker
+		queue.failures = 0;
+		this->setBreaker(serverAddress, BreakerState::Closed);
+		return;
+	}
+	queue.failures++;
+	// failed probe, wait another interval
+	if (queue.breaker == BreakerState::HalfOpen)
+	{
+		this->setBreaker(serverAddress, BreakerState::Open);
+		return;
+	}
+	if (queue.breaker == BreakerState::Open || m_breakerThreshold <= 0 || queue.failures < m_breakerThreshold)
+	{
+		return;
+	}
+	queue.lastProbe = m_clock.elapsed();
+	this->setBreaker(serverAddress, BreakerState::Open);
+	QMutexLocker locker(&m_statsMutex);
+	m_stats[serverAddress].breakerTrips++;
+}
+
+void QUaModbusScheduler::updateTiming(const quint8 & serverAddress, const QModbusError & error, const double & responseTime, const int & requestSize, const int & responseSize)
+{
+	if (m_charTime <= 0.0)
+	{
+		return;
+	}
+	// time the frames were actually on the bus
+	auto frameTime = (requestSize + responseSize) * m_charTime;
+	m_frameTime += frameTime;
+	if (error == QModbusError::TimeoutError || responseSize == 0)
+	{
+		return;
+	}
+	// turnaround is what is left after transmitting and the silent intervals
+	auto turnaroundTime = qMax(0.0, responseTime - (frameTime + 2.0 * m_interFrameTime) / 1000.0);
+	QMutexLocker locker(&m_statsMutex);
+	auto &stats = m_stats[serverAddress];
+	stats.turnaroundTime = stats.turnaroundTime <= 0.0 ?
+		turnaroundTime : 0.875 * stats.turnaroundTime + 0.125 * turnaroundTime;
+}
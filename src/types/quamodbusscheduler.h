@@ -0,0 +1,197 @@
+#ifndef QUAMODBUSSCHEDULER_H
+#define QUAMODBUSSCHEDULER_H
+
+#include <QObject>
+#include <QModbusReply>
+#include <QModbusDataUnit>
+#include <QPointer>
+#include <QQueue>
+#include <QMap>
+#include <QMutex>
+#include <QElapsedTimer>
+
+#include <functional>
+
+typedef QModbusDevice::Error QModbusError;
+
+// NOTE : statistics of a single modbus server (unit id) on the bus, times in ms
+struct QUaModbusSlaveStats
+{
+	quint64 requests         = 0;
+	quint64 responses        = 0;
+	quint64 errors           = 0;
+	quint64 timeouts         = 0;
+	double  lastResponseTime = 0.0;
+	double  avgResponseTime  = 0.0;
+	double  maxResponseTime  = 0.0;
+	double  turnaroundTime   = 0.0;
+	double  writeQueueTime   = 0.0;
+	double  maxWriteQueueTime = 0.0;
+	quint64 breakerTrips     = 0;
+	int     breakerState     = 0; // QUaModbusScheduler::BreakerState
+};
+
+// NOTE : serializes the requests of all the blocks and values of a client
+//        serving the modbus servers (unit ids) in deficit round-robin order (cost is bus time)
+//        each server has a circuit breaker, a dead server is only probed so it cannot stall the healthy ones
+//        (also its writes and group reads, they wait in their lane and one at a time goes as probe)
+//        writes are commands, they go in a separate queue that is always served before reads
+//        reads of a read group go in another one, served right after writes so they are sent back-to-back
+//        standby reads check another endpoint of the same server, they do not count for its health nor statistics
+//        must only be used in the worker thread of the client, except for the statistics
+class QUaModbusScheduler : public QObject
+{
+	Q_OBJECT
+
+public:
+	explicit QUaModbusScheduler(QObject *parent = nullptr);
+
+	enum RequestKind
+	{
+		Read        = 0,
+		Write       = 1,
+		GroupRead   = 2,
+		Standby     = 3,
+		CounterRead = 4
+	};
+
+	enum BreakerState
+	{
+		Closed   = 0, // normal polling
+		Open     = 1, // no polling, only a probe read every probe interval
+		HalfOpen = 2  // probe read in flight
+	};
+	Q_ENUM(BreakerState)
+
+	// must send the request and return the reply, or nullptr if there is nothing to wait for
+	typedef std::function<QModbusReply*()> QUaModbusSendFunc;
+
+	// NOTE : 0 means unlimited (let the modbus client queue)
+	int  maxInFlight() const;
+	void setMaxInFlight(const int &maxInFlight);
+
+	// open the breaker of a server after this many consecutive failures (0 disables)
+	//        failures are timeouts, or a gateway reporting the target did not respond
+	int  breakerThreshold() const;
+	void setBreakerThreshold(const int &breakerThreshold);
+
+	// an open breaker sends one probe read per interval (ms), it closes when a probe is answered
+	int  probeInterval() const;
+	void setProbeInterval(const int &probeInterval);
+
+	BreakerState breakerState(const quint8 &serverAddress) const;
+
+	// serial line timing in us, character time 0 means not serial (no timing measurements)
+	void setCharTime      (const double &charTime);
+	void setInterFrameTime(const double &interFrameTime);
+
+	// silence (ms) to keep on the bus before sending a request to each server
+	void setSlaveDelays(const QMap<quint8, int> &slaveDelays);
+
+	// NOTE : in adaptive mode the request timeout is derived from the smoothed round trip time
+	//        and its variance (as TCP does), the configured timeout is then the upper bound
+	void setTimeout(const int &timeout, const bool &adaptive);
+	// request timeout (ms) to use in the modbus client
+	int  timeout() const;
+
+	// percentage of time the bus carried frames since the last call
+	double takeBusUtilization();
+
+	// NOTE : returns false if a read of the same owner and kind is already queued (read is coalesced)
+	//        the queued one is not sent yet, so it serves the caller as well
+	//        standby reads are coalesced the same way, the owner being the standby modbus client
+	//        also false for a read while a group read of the same owner is queued, and the reverse
+	//        request size is the number of bytes of the request frame (RTU)
+	bool enqueue(
+		const quint8            &serverAddress,
+		QObject                 *owner,
+		const RequestKind       &kind,
+		const QUaModbusSendFunc &send,
+		const int               &requestSize = 8
+	);
+	// true if a request of the owner and kind is waiting to be sent
+	bool isQueued(const quint8 &serverAddress, QObject *owner, const RequestKind &kind) const;
+	// discard queued requests and forget pending replies (e.g. on disconnection)
+	void clear();
+	// forget pending replies but keep queues and breakers (e.g. on failover to another modbus client)
+	void abandonInFlight();
+
+	// NOTE : thread-safe
+	QMap<quint8, QUaModbusSlaveStats> slaveStats() const;
+	void resetSlaveStats();
+
+	// size of the RTU frame of a write request
+	static int writeRequestSize(const QModbusDataUnit::RegisterType &type, const int &count);
+
+signals:
+	// time (ms) a write waited in queue before being sent
+	void writeDispatched(const double &queueTime);
+	// request timeout (ms) to use in the modbus client changed
+	void timeoutChanged(const int &timeout);
+	void breakerStateChanged(const quint8 &serverAddress, const QUaModbusScheduler::BreakerState &state);
+	void requestTimedOut(const quint8 &serverAddress);
+
+private:
+	struct QUaModbusRequest
+	{
+		QPointer<QObject> owner;
+		RequestKind       kind;
+		QUaModbusSendFunc send;
+		int               requestSize;
+		quint8            serverAddress;
+		qint64            enqueueTime; // ns
+	};
+	struct QUaModbusSlaveQueue
+	{
+		QQueue<QUaModbusRequest> requests;
+		double deficit      = 0.0;  // ms
+		double cost         = 50.0; // ms, one quantum until measured
+		int    failures     = 0;    // consecutive
+		BreakerState breaker = Closed;
+		qint64 lastProbe    = 0;    // ms
+	};
+	int     m_maxInFlight;
+	int     m_inFlight;
+	int     m_lastServed;
+	quint32 m_generation;
+	int     m_breakerThreshold;
+	int     m_probeInterval;
+	bool    m_probePending;
+	bool    m_delayPending;
+	double  m_charTime;
+	double  m_interFrameTime;
+	double  m_frameTime;     // us
+	int     m_timeout;       // ms
+	bool    m_adaptive;
+	double  m_srtt;          // ms, negative if no sample yet
+	double  m_rttvar;        // ms
+	double  m_rto;           // ms
+	qint64  m_lastFinish;    // ms
+	qint64  m_lastTake;      // ms
+	QMap<quint8, int> m_slaveDelays;
+	QElapsedTimer m_clock;
+	QMap<quint8, QUaModbusSlaveQueue> m_queues;
+	QQueue<QUaModbusRequest> m_writes;
+	QQueue<QUaModbusRequest> m_groupReads;
+	QQueue<QUaModbusRequest> m_standbyReads;
+	mutable QMutex m_statsMutex;
+	QMap<quint8, QUaModbusSlaveStats> m_stats;
+
+	static double m_quantum;
+	static double m_minTimeout;
+
+	void dispatch();
+	int  nextInLane(const QQueue<QUaModbusRequest> &lane, const qint64 &now);
+	bool hasLaneRequest(const quint8 &serverAddress) const;
+	int  nextHealthy(const qint64 &now);
+	int  nextProbe(const qint64 &now);
+	void setBreaker(const quint8 &serverAddress, const BreakerState &state);
+	void send(const quint8 &serverAddress, const QUaModbusRequest &request);
+	void updateStats(const quint8 &serverAddress, const QModbusError &error, const double &responseTime);
+	void updateHealth(const quint8 &serverAddress, const bool &failed, const double &responseTime);
+	void updateQueueTime(const quint8 &serverAddress, const double &queueTime);
+	void updateTimeout(const QModbusError &error, const double &responseTime);
+	void updateTiming(const quint8 &serverAddress, const QModbusError &error, const double &responseTime, const int &requestSize, const int &responseSize);
+};
+
+#endif // QUAMODBUSSCHEDULER_H
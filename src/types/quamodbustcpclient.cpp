@@ -4,30 +4,92 @@
 #include <QUaPermissions>
 #endif // QUA_ACCESS_CONTROL
 
+int QUaModbusTcpClient::m_standbyProbeInterval = 2000;
+
 QUaModbusTcpClient::QUaModbusTcpClient(QUaServer *server)
 	: QUaModbusClient(server)
 {
+	m_loopHandle     = -1;
+	m_activeEndpoint = QModbusEndpoint::Primary;
+	m_standbyHealthy = false;
+	if (QMetaType::type("QModbusEndpoint") == QMetaType::UnknownType)
+	{
+		qRegisterMetaType<QModbusEndpoint>("QModbusEndpoint");
+	}
 	// set defaults
 	type          ()->setDataTypeEnum(QMetaEnum::fromType<QModbusClientType>());
 	type          ()->setValue(QModbusClientType::Tcp);
 	networkAddress()->setValue("127.0.0.1");
 	networkPort   ()->setDataType(QMetaType::UShort);
 	networkPort   ()->setValue(502);
+	secondaryNetworkAddress()->setValue("");
+	secondaryNetworkPort   ()->setDataType(QMetaType::UShort);
+	secondaryNetworkPort   ()->setValue(502);
+	activeEndpoint()->setDataTypeEnum(QMetaEnum::fromType<QModbusEndpoint>());
+	activeEndpoint()->setValue(QModbusEndpoint::Primary);
 	// set initial conditions
 	networkAddress()->setWriteAccess(true);
 	networkPort   ()->setWriteAccess(true);
+	secondaryNetworkAddress()->setWriteAccess(true);
+	secondaryNetworkPort   ()->setWriteAccess(true);
+	// to safely update state, error and endpoint in ua server thread
+	QObject::connect(this, &QUaModbusTcpClient::updateState         , this, &QUaModbusTcpClient::on_stateChanged);
+	QObject::connect(this, &QUaModbusTcpClient::updateState         , this, &QUaModbusTcpClient::on_updateState);
+	QObject::connect(this, &QUaModbusTcpClient::updateError         , this, &QUaModbusTcpClient::on_errorChanged);
+	QObject::connect(this, &QUaModbusTcpClient::updateActiveEndpoint, this, &QUaModbusTcpClient::on_updateActiveEndpoint);
 	// instantiate client
 	this->resetModbusClient();
+	// fail over as soon as the server of this client does not answer on the active endpoint
+	m_workerThread.execInThread([this]() {
+		QObject::connect(m_scheduler.data(), &QUaModbusScheduler::requestTimedOut, m_scheduler.data(),
+		[this](const quint8 &serverAddress) {
+			if (serverAddress != this->getServerAddress() || m_disconnectRequested)
+			{
+				return;
+			}
+			this->failover();
+		});
+	});
+	// keep the standby endpoint connected and probe it while the active one is in use
+	m_loopHandle = m_workerThread.startLoopInThread([this]() {
+		if (!m_standbyClient || m_modbusClient->state() != QModbusDevice::ConnectedState)
+		{
+			return;
+		}
+		if (m_standbyClient->state() == QModbusDevice::UnconnectedState)
+		{
+			m_standbyClient->connectDevice();
+		}
+		else if (m_standbyClient->state() == QModbusDevice::ConnectedState)
+		{
+			this->probeStandby();
+		}
+	}, m_standbyProbeInterval);
 	// handle changes
 	QObject::connect(networkAddress(), &QUaBaseVariable::valueChanged, this, &QUaModbusTcpClient::on_networkAddressChanged, Qt::QueuedConnection);
 	QObject::connect(networkPort()   , &QUaBaseVariable::valueChanged, this, &QUaModbusTcpClient::on_networkPortChanged   , Qt::QueuedConnection);
+	QObject::connect(secondaryNetworkAddress(), &QUaBaseVariable::valueChanged, this, &QUaModbusTcpClient::on_secondaryNetworkAddressChanged, Qt::QueuedConnection);
+	QObject::connect(secondaryNetworkPort()   , &QUaBaseVariable::valueChanged, this, &QUaModbusTcpClient::on_secondaryNetworkPortChanged   , Qt::QueuedConnection);
 	// set descriptions
 	/*
 	networkAddress()->setDescription(tr("Network address (IP address or domain name) of the Modbus server."));
 	networkPort()   ->setDescription(tr("Network port (TCP port) of the Modbus server."));
+	secondaryNetworkAddress()->setDescription(tr("Network address of the hot standby Modbus server. Empty to disable."));
+	secondaryNetworkPort()   ->setDescription(tr("Network port of the hot standby Modbus server."));
+	activeEndpoint()->setDescription(tr("Endpoint (primary or secondary) currently used to poll the Modbus server."));
 	*/
 }
 
+QUaModbusTcpClient::~QUaModbusTcpClient()
+{
+	// stop loop before anything else is destroyed
+	if (m_loopHandle > 0)
+	{
+		m_workerThread.stopLoopInThread(m_loopHandle);
+	}
+	m_loopHandle = -1;
+}
+
 QUaProperty * QUaModbusTcpClient::networkAddress() const
 {
 	QMutexLocker locker(&(const_cast<QUaModbusTcpClient*>(this)->m_mutex));
@@ -40,6 +102,24 @@ QUaProperty * QUaModbusTcpClient::networkPort() const
 	return const_cast<QUaModbusTcpClient*>(this)->browseChild<QUaProperty>("NetworkPort");
 }
 
+QUaProperty * QUaModbusTcpClient::secondaryNetworkAddress() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusTcpClient*>(this)->m_mutex));
+	return const_cast<QUaModbusTcpClient*>(this)->browseChild<QUaProperty>("SecondaryNetworkAddress");
+}
+
+QUaProperty * QUaModbusTcpClient::secondaryNetworkPort() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusTcpClient*>(this)->m_mutex));
+	return const_cast<QUaModbusTcpClient*>(this)->browseChild<QUaProperty>("SecondaryNetworkPort");
+}
+
+QUaBaseDataVariable * QUaModbusTcpClient::activeEndpoint() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusTcpClient*>(this)->m_mutex));
+	return const_cast<QUaModbusTcpClient*>(this)->browseChild<QUaBaseDataVariable>("ActiveEndpoint");
+}
+
 QString QUaModbusTcpClient::getNetworkAddress() const
 {
 	QMutexLocker locker(&(const_cast<QUaModbusTcpClient*>(this)->m_mutex));
@@ -66,22 +146,211 @@ void QUaModbusTcpClient::setNetworkPort(const quint16 & networkPort)
 	this->on_networkPortChanged(networkPort);
 }
 
+QString QUaModbusTcpClient::getSecondaryNetworkAddress() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusTcpClient*>(this)->m_mutex));
+	return this->secondaryNetworkAddress()->value().toString();
+}
+
+void QUaModbusTcpClient::setSecondaryNetworkAddress(const QString & strSecondaryNetworkAddress)
+{
+	QMutexLocker locker(&m_mutex);
+	this->secondaryNetworkAddress()->setValue(strSecondaryNetworkAddress);
+	this->on_secondaryNetworkAddressChanged(strSecondaryNetworkAddress);
+}
+
+quint16 QUaModbusTcpClient::getSecondaryNetworkPort() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusTcpClient*>(this)->m_mutex));
+	return this->secondaryNetworkPort()->value().value<quint16>();
+}
+
+void QUaModbusTcpClient::setSecondaryNetworkPort(const quint16 & secondaryNetworkPort)
+{
+	QMutexLocker locker(&m_mutex);
+	this->secondaryNetworkPort()->setValue(secondaryNetworkPort);
+	this->on_secondaryNetworkPortChanged(secondaryNetworkPort);
+}
+
+QModbusEndpoint QUaModbusTcpClient::getActiveEndpoint() const
+{
+	QMutexLocker locker(&(const_cast<QUaModbusTcpClient*>(this)->m_mutex));
+	return this->activeEndpoint()->value().value<QModbusEndpoint>();
+}
+
 void QUaModbusTcpClient::resetModbusClient()
 {
     m_workerThread.execInThread([this]() {
+		// start over from the primary endpoint
+		m_activeEndpoint = QModbusEndpoint::Primary;
 		// instantiate in thread so it runs on the thread
-		m_modbusClient.reset(new QModbusTcpClient(nullptr), [](QObject* client) {
-			client->deleteLater();
+		m_modbusClient = this->createClient(m_activeEndpoint);
+		// tcp can pipeline requests, let the modbus client queue them
+		m_scheduler->setMaxInFlight(0);
+		this->attachActive();
+		this->resetStandbyClient();
+		emit this->updateActiveEndpoint(m_activeEndpoint);
+	});
+}
+
+QSharedPointer<QModbusClient> QUaModbusTcpClient::createClient(const QModbusEndpoint & endpoint)
+{
+	QSharedPointer<QModbusClient> client(new QModbusTcpClient(nullptr), [](QObject* client) {
+		client->deleteLater();
+	});
+	bool isPrimary = endpoint == QModbusEndpoint::Primary;
+	client->setConnectionParameter(QModbusDevice::NetworkAddressParameter, isPrimary ? this->getNetworkAddress() : this->getSecondaryNetworkAddress());
+	client->setConnectionParameter(QModbusDevice::NetworkPortParameter   , isPrimary ? this->getNetworkPort   () : this->getSecondaryNetworkPort   ());
+	return client;
+}
+
+QModbusClient * QUaModbusTcpClient::endpointClient(const QModbusEndpoint & endpoint) const
+{
+	return endpoint == m_activeEndpoint ? m_modbusClient.data() : m_standbyClient.data();
+}
+
+void QUaModbusTcpClient::resetStandbyClient()
+{
+	if (m_standbyClient)
+	{
+		QObject::disconnect(m_standbyClient.data());
+		m_standbyClient->disconnectDevice();
+		m_standbyClient.clear();
+	}
+	m_standbyHealthy = false;
+	if (this->getSecondaryNetworkAddress().isEmpty())
+	{
+		return;
+	}
+	// standby is the endpoint that is not active, connected by the probe loop
+	m_standbyClient = this->createClient(
+		m_activeEndpoint == QModbusEndpoint::Primary ? QModbusEndpoint::Secondary : QModbusEndpoint::Primary
+	);
+	m_standbyClient->setTimeout(m_scheduler->timeout());
+	m_standbyClient->setNumberOfRetries(0);
+	// probe as soon as connected, a failover should not wait for the next probe
+	QObject::connect(m_standbyClient.data(), &QModbusClient::stateChanged, m_standbyClient.data(),
+	[this](QModbusDevice::State state) {
+		if (state == QModbusDevice::ConnectedState)
+		{
+			this->probeStandby();
+			return;
+		}
+		m_standbyHealthy = false;
+	});
+}
+
+void QUaModbusTcpClient::attachActive()
+{
+	// setup client (call base class method)
+	this->QUaModbusClient::resetModbusClient();
+	// NOTE : state and errors are filtered in thread, so a failover hides the loss of the active endpoint
+	QObject::disconnect(m_modbusClient.data(), nullptr, this, nullptr);
+	QObject::connect(m_modbusClient.data(), &QModbusClient::stateChanged, m_modbusClient.data(),
+	[this](QModbusDevice::State state) {
+		if (state == QModbusDevice::UnconnectedState && !m_disconnectRequested && m_standbyClient)
+		{
+			if (this->failover())
+			{
+				return;
+			}
+			// nothing to take over, try the other endpoint on the next connection attempt
+			this->rotateEndpoint();
+		}
+		emit this->updateState(state);
+	});
+	QObject::connect(m_modbusClient.data(), &QModbusClient::errorOccurred, m_modbusClient.data(),
+	[this](QModbusDevice::Error error) {
+		if (error == QModbusDevice::ConnectionError && !m_disconnectRequested && this->failover())
+		{
+			return;
+		}
+		emit this->updateError(error);
+	});
+}
+
+void QUaModbusTcpClient::probeStandby()
+{
+	auto client        = m_standbyClient.data();
+	auto serverAddress = this->getServerAddress();
+	// share the scheduler with the active endpoint, a probe must not jump ahead of writes
+	m_scheduler->enqueue(serverAddress, client, QUaModbusScheduler::Standby,
+	[this, client, serverAddress]() -> QModbusReply* {
+		// standby might have been replaced while queued
+		if (client != m_standbyClient.data() || client->state() != QModbusDevice::ConnectedState)
+		{
+			return nullptr;
+		}
+		auto reply = client->sendReadRequest(QModbusDataUnit(QModbusDataUnit::HoldingRegisters, 0, 1), serverAddress);
+		if (!reply)
+		{
+			m_standbyHealthy = false;
+			return nullptr;
+		}
+		if (reply->isFinished())
+		{
+			reply->deleteLater();
+			return nullptr;
+		}
+		QObject::connect(reply, &QModbusReply::finished, reply,
+		[this, client, reply]() {
+			reply->deleteLater();
+			// standby might have been replaced meanwhile
+			if (client != m_standbyClient.data())
+			{
+				return;
+			}
+			// any answer means the server is alive, even an exception (e.g. illegal address)
+			// but not a gateway reporting the server behind it did not respond
+			auto error = reply->error();
+			auto exceptionCode = reply->rawResult().exceptionCode();
+			m_standbyHealthy = error == QModbusDevice::NoError || (
+				error == QModbusDevice::ProtocolError &&
+				exceptionCode != QModbusPdu::GatewayPathUnavailable &&
+				exceptionCode != QModbusPdu::GatewayTargetDeviceFailedToRespond
+			);
 		});
-		// defaults
-		m_modbusClient->setConnectionParameter(QModbusDevice::NetworkAddressParameter, this->getNetworkAddress());
-		m_modbusClient->setConnectionParameter(QModbusDevice::NetworkPortParameter   , this->getNetworkPort   ());
-		// setup client (call base class method)
-        this->QUaModbusClient::resetModbusClient();
-		QObject::connect(m_modbusClient.data(), &QModbusClient::stateChanged, this, &QUaModbusTcpClient::on_stateChanged, Qt::QueuedConnection);
+		return reply;
 	});
 }
 
+bool QUaModbusTcpClient::failover()
+{
+	// only worth it if the standby is known to answer
+	if (!m_standbyClient || !m_standbyHealthy ||
+		m_standbyClient->state() != QModbusDevice::ConnectedState)
+	{
+		return false;
+	}
+	// stop listening to the failed client before closing it
+	auto failedClient = m_modbusClient;
+	QObject::disconnect(failedClient.data());
+	failedClient->disconnectDevice();
+	// standby takes over as it is, already connected
+	QObject::disconnect(m_standbyClient.data());
+	m_modbusClient = m_standbyClient;
+	m_standbyClient.clear();
+	m_activeEndpoint = m_activeEndpoint == QModbusEndpoint::Primary ? QModbusEndpoint::Secondary : QModbusEndpoint::Primary;
+	// replies of the failed client are lost, queued requests and breakers are kept
+	m_scheduler->abandonInFlight();
+	this->attachActive();
+	// failed endpoint becomes the standby
+	this->resetStandbyClient();
+	emit this->updateActiveEndpoint(m_activeEndpoint);
+	return true;
+}
+
+void QUaModbusTcpClient::rotateEndpoint()
+{
+	QObject::disconnect(m_modbusClient.data());
+	m_modbusClient->disconnectDevice();
+	m_activeEndpoint = m_activeEndpoint == QModbusEndpoint::Primary ? QModbusEndpoint::Secondary : QModbusEndpoint::Primary;
+	m_modbusClient = this->createClient(m_activeEndpoint);
+	this->attachActive();
+	this->resetStandbyClient();
+	emit this->updateActiveEndpoint(m_activeEndpoint);
+}
+
 QDomElement QUaModbusTcpClient::toDomElement(QDomDocument & domDoc) const
 {
 	// add client element
@@ -97,8 +366,11 @@ QDomElement QUaModbusTcpClient::toDomElement(QDomDocument & domDoc) const
 	elemTcpClient.setAttribute("BrowseName"    , this->browseName() );
 	elemTcpClient.setAttribute("ServerAddress" , getServerAddress ());
 	elemTcpClient.setAttribute("KeepConnecting", getKeepConnecting());
+	this->toDomElementCommon(elemTcpClient);
 	elemTcpClient.setAttribute("NetworkAddress", getNetworkAddress());
 	elemTcpClient.setAttribute("NetworkPort"   , getNetworkPort   ());
+	elemTcpClient.setAttribute("SecondaryNetworkAddress", getSecondaryNetworkAddress());
+	elemTcpClient.setAttribute("SecondaryNetworkPort"   , getSecondaryNetworkPort   ());
 	// add block list element
 	auto elemBlockList = const_cast<QUaModbusTcpClient*>(this)->dataBlocks()->toDomElement(domDoc);
 	elemTcpClient.appendChild(elemBlockList);
@@ -155,6 +427,8 @@ void QUaModbusTcpClient::fromDomElement(QDomElement & domElem, QQueue<QUaLog>& e
 			QUaLogCategory::Serialization
 		);
 	}
+	// attributes common to all clients
+	this->fromDomElementCommon(domElem, errorLogs);
 	// NetworkAddress
 	auto networkAddress = domElem.attribute("NetworkAddress");
 	if (!networkAddress.isEmpty())
@@ -183,6 +457,28 @@ void QUaModbusTcpClient::fromDomElement(QDomElement & domElem, QQueue<QUaLog>& e
 			QUaLogCategory::Serialization
 		);
 	}
+	// SecondaryNetworkAddress (optional)
+	if (domElem.hasAttribute("SecondaryNetworkAddress"))
+	{
+		this->setSecondaryNetworkAddress(domElem.attribute("SecondaryNetworkAddress"));
+	}
+	// SecondaryNetworkPort (optional)
+	if (domElem.hasAttribute("SecondaryNetworkPort"))
+	{
+		auto secondaryNetworkPort = domElem.attribute("SecondaryNetworkPort").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setSecondaryNetworkPort(secondaryNetworkPort);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid SecondaryNetworkPort attribute '%1' in Modbus client %2. Default value set.").arg(domElem.attribute("SecondaryNetworkPort")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
 	// get block list
 	QDomElement elemBlockList = domElem.firstChildElement(QUaModbusDataBlockList::staticMetaObject.className());
 	if (!elemBlockList.isNull())
@@ -199,18 +495,22 @@ void QUaModbusTcpClient::fromDomElement(QDomElement & domElem, QQueue<QUaLog>& e
 	}
 }
 
-void QUaModbusTcpClient::on_stateChanged(const QModbusDevice::State &state)
+void QUaModbusTcpClient::on_updateState(const QModbusState &state)
 {
 	// only allow to write connection params if not connected
 	if (state == QModbusDevice::State::UnconnectedState)
 	{
 		networkAddress()->setWriteAccess(true);
 		networkPort   ()->setWriteAccess(true);
+		secondaryNetworkAddress()->setWriteAccess(true);
+		secondaryNetworkPort   ()->setWriteAccess(true);
 	}
 	else
 	{
 		networkAddress()->setWriteAccess(false);
 		networkPort   ()->setWriteAccess(false);
+		secondaryNetworkAddress()->setWriteAccess(false);
+		secondaryNetworkPort   ()->setWriteAccess(false);
 	}
 }
 
@@ -221,7 +521,11 @@ void QUaModbusTcpClient::on_networkAddressChanged(const QVariant & value)
 	QString strNetworkAddress = value.toString();
 	// set in thread, for thread-safety
 	m_workerThread.execInThread([this, strNetworkAddress]() {
-		m_modbusClient->setConnectionParameter(QModbusDevice::NetworkAddressParameter, strNetworkAddress);
+		auto client = this->endpointClient(QModbusEndpoint::Primary);
+		if (client)
+		{
+			client->setConnectionParameter(QModbusDevice::NetworkAddressParameter, strNetworkAddress);
+		}
 	});
 	// emit
 	emit this->networkAddressChanged(strNetworkAddress);
@@ -234,8 +538,72 @@ void QUaModbusTcpClient::on_networkPortChanged(const QVariant & value)
 	quint16 uiPort = value.value<quint16>();
 	// set in thread, for thread-safety
 	m_workerThread.execInThread([this, uiPort]() {
-		m_modbusClient->setConnectionParameter(QModbusDevice::NetworkPortParameter, uiPort);
+		auto client = this->endpointClient(QModbusEndpoint::Primary);
+		if (client)
+		{
+			client->setConnectionParameter(QModbusDevice::NetworkPortParameter, uiPort);
+		}
 	});
 	// emit
 	emit this->networkPortChanged(uiPort);
 }
+
+void QUaModbusTcpClient::on_secondaryNetworkAddressChanged(const QVariant & value)
+{
+	// NOTE : if connected, will not change until reconnect
+	QString strSecondaryNetworkAddress = value.toString();
+	// set in thread, for thread-safety
+	m_workerThread.execInThread([this, strSecondaryNetworkAddress]() {
+		if (m_activeEndpoint == QModbusEndpoint::Secondary && !strSecondaryNetworkAddress.isEmpty())
+		{
+			m_modbusClient->setConnectionParameter(QModbusDevice::NetworkAddressParameter, strSecondaryNetworkAddress);
+			return;
+		}
+		// secondary removed while in use, fall back to the primary
+		if (m_activeEndpoint == QModbusEndpoint::Secondary)
+		{
+			if (this->failover())
+			{
+				return;
+			}
+			bool wasConnected = m_modbusClient->state() != QModbusDevice::UnconnectedState;
+			m_scheduler->abandonInFlight();
+			this->rotateEndpoint();
+			if (wasConnected && !m_disconnectRequested)
+			{
+				m_modbusClient->connectDevice();
+			}
+			return;
+		}
+		// create, replace or remove standby
+		this->resetStandbyClient();
+	});
+	// emit
+	emit this->secondaryNetworkAddressChanged(strSecondaryNetworkAddress);
+}
+
+void QUaModbusTcpClient::on_secondaryNetworkPortChanged(const QVariant & value)
+{
+	// NOTE : if connected, will not change until reconnect
+	quint16 uiPort = value.value<quint16>();
+	// set in thread, for thread-safety
+	m_workerThread.execInThread([this, uiPort]() {
+		auto client = this->endpointClient(QModbusEndpoint::Secondary);
+		if (client)
+		{
+			client->setConnectionParameter(QModbusDevice::NetworkPortParameter, uiPort);
+		}
+	});
+	// emit
+	emit this->secondaryNetworkPortChanged(uiPort);
+}
+
+void QUaModbusTcpClient::on_updateActiveEndpoint(const QModbusEndpoint & activeEndpoint)
+{
+	if (this->activeEndpoint()->value().value<QModbusEndpoint>() == activeEndpoint)
+	{
+		return;
+	}
+	this->activeEndpoint()->setValue(activeEndpoint);
+	emit this->activeEndpointChanged(activeEndpoint);
+}
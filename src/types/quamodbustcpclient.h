@@ -14,14 +14,34 @@ class QUaModbusTcpClient : public QUaModbusClient
 	// UA properties
 	Q_PROPERTY(QUaProperty * NetworkAddress  READ networkAddress)
 	Q_PROPERTY(QUaProperty * NetworkPort     READ networkPort   )
+	Q_PROPERTY(QUaProperty * SecondaryNetworkAddress READ secondaryNetworkAddress)
+	Q_PROPERTY(QUaProperty * SecondaryNetworkPort    READ secondaryNetworkPort   )
+
+	// UA variables
+	Q_PROPERTY(QUaBaseDataVariable * ActiveEndpoint READ activeEndpoint)
 
 public:
 	Q_INVOKABLE explicit QUaModbusTcpClient(QUaServer *server);
+	~QUaModbusTcpClient();
+
+	enum Endpoint
+	{
+		Primary   = 0,
+		Secondary = 1
+	};
+	Q_ENUM(Endpoint)
+	typedef QUaModbusTcpClient::Endpoint QModbusEndpoint;
 
 	// UA properties
 
 	QUaProperty * networkAddress() const;
 	QUaProperty * networkPort() const;
+	QUaProperty * secondaryNetworkAddress() const;
+	QUaProperty * secondaryNetworkPort() const;
+
+	// UA variables
+
+	QUaBaseDataVariable * activeEndpoint() const;
 
 	// C++ API (all is read/write)
 
@@ -31,10 +51,28 @@ public:
 	quint16  getNetworkPort() const;
 	void     setNetworkPort(const quint16 &networkPort);
 
+	// NOTE : hot standby, an empty address disables it
+	//        the standby endpoint is kept connected and probed while the active one is connected
+	QString  getSecondaryNetworkAddress() const;
+	void     setSecondaryNetworkAddress(const QString &strSecondaryNetworkAddress);
+
+	quint16  getSecondaryNetworkPort() const;
+	void     setSecondaryNetworkPort(const quint16 &secondaryNetworkPort);
+
+	QModbusEndpoint getActiveEndpoint() const;
+
 signals:
 	// C++ API
 	void networkAddressChanged(const QString &strNetworkAddress);
 	void networkPortChanged(const quint16 &networkPort);
+	void secondaryNetworkAddressChanged(const QString &strSecondaryNetworkAddress);
+	void secondaryNetworkPortChanged(const quint16 &secondaryNetworkPort);
+	void activeEndpointChanged(const QModbusEndpoint &activeEndpoint);
+
+	// (internal) to safely update state, error and endpoint in ua server thread
+	void updateState(const QModbusState &state);
+	void updateError(const QModbusError &error);
+	void updateActiveEndpoint(const QModbusEndpoint &activeEndpoint);
 
 protected:
 	void resetModbusClient() override;
@@ -43,11 +81,34 @@ protected:
 	void        fromDomElement(QDomElement  & domElem, QQueue<QUaLog>& errorLogs) override;
 
 private slots:
-	void on_stateChanged         (const QModbusDevice::State &state);
+	void on_updateState          (const QModbusState &state);
 	void on_networkAddressChanged(const QVariant &value);
 	void on_networkPortChanged   (const QVariant &value);
-
+	void on_secondaryNetworkAddressChanged(const QVariant &value);
+	void on_secondaryNetworkPortChanged   (const QVariant &value);
+	void on_updateActiveEndpoint(const QModbusEndpoint &activeEndpoint);
+
+private:
+	int m_loopHandle;
+	// NOTE : only use in thread
+	QSharedPointer<QModbusClient> m_standbyClient;
+	QModbusEndpoint m_activeEndpoint;
+	bool m_standbyHealthy;
+	// NOTE : only call in thread
+	QSharedPointer<QModbusClient> createClient(const QModbusEndpoint &endpoint);
+	QModbusClient * endpointClient(const QModbusEndpoint &endpoint) const;
+	void resetStandbyClient();
+	void attachActive();
+	void probeStandby();
+	// standby takes over, false if it is not known to answer
+	bool failover();
+	// next connection attempt goes to the other endpoint
+	void rotateEndpoint();
+
+	static int m_standbyProbeInterval;
 };
 
+typedef QUaModbusTcpClient::Endpoint QModbusEndpoint;
+
 #endif // QUAMODBUSTCPCLIENT_H
 
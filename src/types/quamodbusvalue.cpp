@@ -6,6 +6,8 @@
 #include <QUaProperty>
 #include <QUaBaseDataVariable>
 
+#include <QPointer>
+
 #ifdef QUA_ACCESS_CONTROL
 #include <QUaPermissions>
 #endif // QUA_ACCESS_CONTROL
@@ -22,12 +24,19 @@ QUaModbusValue::QUaModbusValue(QUaServer *server)
 	m_type = nullptr;
 	m_registersUsed = nullptr;
 	m_addressOffset = nullptr;
+	m_minWriteInterval = nullptr;
 #ifndef QUAMODBUS_NOCYCLIC_WRITE
 	m_cyclicWritePeriod = nullptr;
 	m_cyclicWriteMode = nullptr;
 #endif // !QUAMODBUS_NOCYCLIC_WRITE
 	m_value = nullptr;
 	m_lastError = nullptr;
+	m_droppedWrites = nullptr;
+	m_droppedWritesCount = 0;
+	m_bufferSize = nullptr;
+	m_enabled = nullptr;
+	m_buffer = nullptr;
+	m_bufferTimestamps = nullptr;
 	m_typeCache = QModbusValueType::Invalid;
 	m_addressOffsetCache = -1; 
 	m_lastErrorCache = QModbusError::ConfigurationError;
@@ -37,16 +46,34 @@ QUaModbusValue::QUaModbusValue(QUaServer *server)
 	registersUsed    ()->setValue(0);
 	addressOffset    ()->setDataType(QMetaType::Int);
 	addressOffset    ()->setValue(m_addressOffsetCache);
+	minWriteInterval ()->setDataType(QMetaType::UInt);
+	minWriteInterval ()->setValue(0);
 	lastError        ()->setDataTypeEnum(QMetaEnum::fromType<QModbusError>());
 	lastError        ()->setValue(m_lastErrorCache);
+	droppedWrites    ()->setDataType(QMetaType::UInt);
+	droppedWrites    ()->setValue(m_droppedWritesCount);
+	bufferSize       ()->setDataType(QMetaType::UInt);
+	bufferSize       ()->setValue(0);
+	enabled          ()->setValue(true);
+	buffer           ()->setValue(QVariantList());
+	bufferTimestamps ()->setValue(QVariantList());
 	// set initial conditions
 	type             ()->setWriteAccess(true);
 	addressOffset    ()->setWriteAccess(true);
+	minWriteInterval ()->setWriteAccess(true);
+	bufferSize       ()->setWriteAccess(true);
+	enabled          ()->setWriteAccess(true);
 	value            ()->setWriteAccess(false); // set to true, when type != ValueType::Invalid
 	// handle state changes
 	QObject::connect(type()             , &QUaBaseVariable::valueChanged, this, &QUaModbusValue::on_typeChanged             , Qt::QueuedConnection);
 	QObject::connect(addressOffset()    , &QUaBaseVariable::valueChanged, this, &QUaModbusValue::on_addressOffsetChanged    , Qt::QueuedConnection);
 	QObject::connect(value()            , &QUaBaseVariable::valueChanged, this, &QUaModbusValue::on_valueChanged            , Qt::QueuedConnection);
+	QObject::connect(minWriteInterval() , &QUaBaseVariable::valueChanged, this, &QUaModbusValue::on_minWriteIntervalChanged , Qt::QueuedConnection);
+	QObject::connect(bufferSize()       , &QUaBaseVariable::valueChanged, this, &QUaModbusValue::on_bufferSizeChanged       , Qt::QueuedConnection);
+	QObject::connect(enabled()          , &QUaBaseVariable::valueChanged, this, &QUaModbusValue::on_enabledChanged          , Qt::QueuedConnection);
+	// pending write is sent when the minimum interval expires
+	m_writeThrottle.setSingleShot(true);
+	QObject::connect(&m_writeThrottle, &QTimer::timeout, this, &QUaModbusValue::on_writeThrottleTimeout);
 	// to safely update error in ua server thread
 	QObject::connect(this, &QUaModbusValue::updateLastError, this, &QUaModbusValue::on_updateLastError);
 
@@ -57,6 +84,12 @@ QUaModbusValue::QUaModbusValue(QUaServer *server)
 	addressOffset()->setDescription(tr("Offset with respect to the data block."));
 	value()        ->setDescription(tr("The value obtained by converting the registers to the selected type."));
 	lastError()    ->setDescription(tr("Last error obtained while converting registers to value."));
+	minWriteInterval()->setDescription(tr("Minimum time in milliseconds between writes, only the latest value is written."));
+	droppedWrites()->setDescription(tr("Number of writes replaced by a more recent value before being sent."));
+	bufferSize()   ->setDescription(tr("Number of samples published at once in Buffer, with their timestamps in BufferTimestamps (0 disables)."));
+	buffer()       ->setDescription(tr("The last BufferSize samples read, oldest first."));
+	enabled()      ->setDescription(tr("A disabled value is neither updated on reads nor written, but keeps its configuration."));
+	bufferTimestamps()->setDescription(tr("The source timestamps of the samples in Buffer."));
 	*/
 
 #ifndef QUAMODBUS_NOCYCLIC_WRITE
@@ -196,6 +229,10 @@ void QUaModbusValue::on_cyclicWriteModeChanged(const QVariant& value, const bool
 
 void QUaModbusValue::on_cyclicWrite()
 {
+	if (!this->getEnabled())
+	{
+		return;
+	}
 	auto value = this->getValue();
 	// cyclic write logic
 	auto mode = this->getCyclicWriteMode();
@@ -247,6 +284,60 @@ QUaBaseDataVariable * QUaModbusValue::lastError()
 	return m_lastError;
 }
 
+QUaProperty * QUaModbusValue::minWriteInterval()
+{
+	if (!m_minWriteInterval)
+	{
+		m_minWriteInterval = this->browseChild<QUaProperty>("MinWriteInterval");
+	}
+	return m_minWriteInterval;
+}
+
+QUaBaseDataVariable * QUaModbusValue::droppedWrites()
+{
+	if (!m_droppedWrites)
+	{
+		m_droppedWrites = this->browseChild<QUaBaseDataVariable>("DroppedWrites");
+	}
+	return m_droppedWrites;
+}
+
+QUaProperty * QUaModbusValue::bufferSize()
+{
+	if (!m_bufferSize)
+	{
+		m_bufferSize = this->browseChild<QUaProperty>("BufferSize");
+	}
+	return m_bufferSize;
+}
+
+QUaProperty * QUaModbusValue::enabled()
+{
+	if (!m_enabled)
+	{
+		m_enabled = this->browseChild<QUaProperty>("Enabled");
+	}
+	return m_enabled;
+}
+
+QUaBaseDataVariable * QUaModbusValue::buffer()
+{
+	if (!m_buffer)
+	{
+		m_buffer = this->browseChild<QUaBaseDataVariable>("Buffer");
+	}
+	return m_buffer;
+}
+
+QUaBaseDataVariable * QUaModbusValue::bufferTimestamps()
+{
+	if (!m_bufferTimestamps)
+	{
+		m_bufferTimestamps = this->browseChild<QUaBaseDataVariable>("BufferTimestamps");
+	}
+	return m_bufferTimestamps;
+}
+
 void QUaModbusValue::remove()
 {
 	this->deleteLater();
@@ -320,6 +411,54 @@ void QUaModbusValue::setValue(const QVariant & value)
 	this->on_valueChanged(value, true);
 }
 
+quint32 QUaModbusValue::getMinWriteInterval() const
+{
+	return const_cast<QUaModbusValue*>(this)->minWriteInterval()->value<quint32>();
+}
+
+void QUaModbusValue::setMinWriteInterval(const quint32 & minWriteInterval)
+{
+	this->minWriteInterval()->setValue(minWriteInterval);
+	this->on_minWriteIntervalChanged(minWriteInterval, true);
+}
+
+quint32 QUaModbusValue::getDroppedWrites() const
+{
+	return m_droppedWritesCount;
+}
+
+quint32 QUaModbusValue::getBufferSize() const
+{
+	return const_cast<QUaModbusValue*>(this)->bufferSize()->value<quint32>();
+}
+
+void QUaModbusValue::setBufferSize(const quint32 & bufferSize)
+{
+	this->bufferSize()->setValue(bufferSize);
+	this->on_bufferSizeChanged(bufferSize, true);
+}
+
+bool QUaModbusValue::getEnabled() const
+{
+	return const_cast<QUaModbusValue*>(this)->enabled()->value().toBool();
+}
+
+void QUaModbusValue::setEnabled(const bool & enabled)
+{
+	this->enabled()->setValue(enabled);
+	this->on_enabledChanged(enabled, true);
+}
+
+QVariantList QUaModbusValue::getBuffer() const
+{
+	return const_cast<QUaModbusValue*>(this)->buffer()->value().toList();
+}
+
+QVariantList QUaModbusValue::getBufferTimestamps() const
+{
+	return const_cast<QUaModbusValue*>(this)->bufferTimestamps()->value().toList();
+}
+
 QModbusError QUaModbusValue::getLastError() const
 {
 	return m_lastErrorCache;
@@ -369,6 +508,117 @@ void QUaModbusValue::on_valueChanged(const QVariant & value, const bool& network
 	{
 		return;
 	}
+	// rate limit, latest value wins
+	qint64 minWriteInterval = this->getMinWriteInterval();
+	if (minWriteInterval > 0)
+	{
+		qint64 elapsed = m_lastWrite.isValid() ? m_lastWrite.elapsed() : minWriteInterval;
+		if (m_writeThrottle.isActive())
+		{
+			// pending value is superseded
+			m_droppedWritesCount++;
+			this->droppedWrites()->setValue(m_droppedWritesCount);
+			m_pendingWrite = value;
+			return;
+		}
+		if (elapsed < minWriteInterval)
+		{
+			m_pendingWrite = value;
+			m_writeThrottle.start(static_cast<int>(minWriteInterval - elapsed));
+			return;
+		}
+		m_lastWrite.start();
+	}
+	this->write(value);
+}
+
+void QUaModbusValue::on_minWriteIntervalChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto minWriteInterval = value.value<quint32>();
+	// do not hold back the pending write if limit removed
+	if (minWriteInterval == 0 && m_writeThrottle.isActive())
+	{
+		m_writeThrottle.stop();
+		this->on_writeThrottleTimeout();
+	}
+	// emit
+	emit this->minWriteIntervalChanged(minWriteInterval);
+}
+
+void QUaModbusValue::on_bufferSizeChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto bufferSize = value.value<quint32>();
+	// start over, samples collected so far would not match the new size
+	m_bufferValues.clear();
+	m_bufferTimes .clear();
+	// emit
+	emit this->bufferSizeChanged(bufferSize);
+}
+
+void QUaModbusValue::on_enabledChanged(const QVariant & value, const bool & networkChange)
+{
+	if (!networkChange)
+	{
+		return;
+	}
+	auto enabled = value.toBool();
+	if (!enabled)
+	{
+		// drop pending work, nothing is sent while disabled
+		m_writeThrottle.stop();
+		m_pendingWrite = QVariant();
+		m_bufferValues.clear();
+		m_bufferTimes .clear();
+	}
+	// emit
+	emit this->enabledChanged(enabled);
+}
+
+void QUaModbusValue::collectSample(const QVariant & value, const QDateTime & timestamp)
+{
+	auto bufferSize = this->getBufferSize();
+	if (bufferSize == 0)
+	{
+		return;
+	}
+	m_bufferValues << value;
+	m_bufferTimes  << (timestamp.isValid() ? timestamp : QDateTime::currentDateTimeUtc());
+	if (static_cast<quint32>(m_bufferValues.count()) < bufferSize)
+	{
+		return;
+	}
+	// publish all at once
+	this->buffer()          ->setValue(m_bufferValues);
+	this->bufferTimestamps()->setValue(m_bufferTimes);
+	// emit
+	emit this->bufferChanged(m_bufferValues, m_bufferTimes);
+	m_bufferValues.clear();
+	m_bufferTimes .clear();
+}
+
+void QUaModbusValue::on_writeThrottleTimeout()
+{
+	auto value = m_pendingWrite;
+	m_pendingWrite = QVariant();
+	m_lastWrite.start();
+	this->write(value);
+}
+
+void QUaModbusValue::write(const QVariant & value)
+{
+	// disabled values are not written
+	if (!this->getEnabled())
+	{
+		return;
+	}
 	// get block representation of value
 	auto type = this->getType();
 	auto data = QUaModbusValue::valueToBlock(value, type);
@@ -422,6 +672,10 @@ void QUaModbusValue::on_valueChanged(const QVariant & value, const bool& network
 		{
 			return;
 		}
+		if (!block->m_isEnabled)
+		{
+			return;
+		}
 		if (startAddress < 0)
 		{
 			emit this->updateLastError(QModbusError::ConfigurationError);
@@ -446,40 +700,70 @@ void QUaModbusValue::on_valueChanged(const QVariant & value, const bool& network
 			startAddress, 
 			data
 		);
-		// create and send request
-		auto serverAddress = client->getServerAddress();
-		QModbusReply* p_reply = client->m_modbusClient->sendWriteRequest(dataToWrite, serverAddress);
-		if (!p_reply)
+		// write and read back the whole block in the same transaction
+		if (block->useReadWrite(dataToWrite.valueCount()))
 		{
-			emit this->updateLastError(QModbusError::ReplyAbortedError);
+			QPointer<QUaModbusValue> pValue(this);
+			block->enqueueReadWrite(dataToWrite, [pValue, value]() {
+				if (pValue)
+				{
+					emit pValue->valueChanged(value);
+				}
+			});
 			return;
 		}
-		// subscribe to finished
-		QObject::connect(p_reply, &QModbusReply::finished, this,
-		[this, p_reply, value]() mutable {
-			// NOTE : exec'd in ua server thread (not in worker thread)
-			if (this->client()->m_disconnectRequested || this->client()->getState() != QModbusState::ConnectedState)
+		// enqueue request in scheduler, so the bus is shared fairly with the blocks
+		auto serverAddress = block->requestServerAddress();
+		client->m_scheduler->enqueue(serverAddress, this, QUaModbusScheduler::Write,
+		[this, client, dataToWrite, serverAddress, value]() -> QModbusReply* {
+			QPointer<QModbusReply> p_reply = client->m_modbusClient->sendWriteRequest(dataToWrite, serverAddress);
+			if (!p_reply)
 			{
-				auto error = QModbusError::ReplyAbortedError;
-				this->setLastError(error);
-				return;
+				emit this->updateLastError(QModbusError::ReplyAbortedError);
+				return nullptr;
 			}
-			// check if reply still valid
-			if (!p_reply)
+			// broadcast replies finish immediately, there is no answer to wait for
+			if (p_reply->isFinished())
 			{
-				auto error = QModbusError::ReplyAbortedError;
-				this->setLastError(error);
-				return;
+				emit this->updateLastError(p_reply->error());
+				p_reply->deleteLater();
+				emit this->valueChanged(value);
+				return nullptr;
 			}
-			// handle error
-			auto error = p_reply->error();
-			this->setLastError(error);
-			// delete reply on next event loop exec
-			p_reply->deleteLater();
-			p_reply = nullptr;
-			// emit
-			emit this->valueChanged(value);
-		}, Qt::QueuedConnection);
+			// subscribe to finished
+			QObject::connect(p_reply.data(), &QModbusReply::finished, this,
+			[this, p_reply, value]() mutable {
+				// NOTE : exec'd in ua server thread (not in worker thread)
+				if (this->client()->m_disconnectRequested || this->client()->getState() != QModbusState::ConnectedState)
+				{
+					auto error = QModbusError::ReplyAbortedError;
+					this->setLastError(error);
+					return;
+				}
+				// check if reply still valid
+				if (!p_reply)
+				{
+					auto error = QModbusError::ReplyAbortedError;
+					this->setLastError(error);
+					return;
+				}
+				// handle error
+				auto error = p_reply->error();
+				this->setLastError(error);
+				// delete reply on next event loop exec
+				p_reply->deleteLater();
+				p_reply = nullptr;
+				// show the confirmed value without waiting for the next poll
+				auto block = this->block();
+				if (error == QModbusError::NoError && block->getReadbackAfterWrite())
+				{
+					block->readback();
+				}
+				// emit
+				emit this->valueChanged(value);
+			}, Qt::QueuedConnection);
+			return p_reply;
+		}, QUaModbusScheduler::writeRequestSize(dataToWrite.registerType(), dataToWrite.valueCount()));
 	});
 }
 
@@ -501,11 +785,12 @@ void QUaModbusValue::on_updateLastError(const QModbusError & error)
 void QUaModbusValue::setValue(
 	const QVector<quint16>& block, 
 	const QModbusError &blockError,
-	const bool forceIfSame /*= false*/
+	const bool forceIfSame /*= false*/,
+	const QDateTime &timestamp /*= QDateTime()*/
 )
 {
-	// check configuration
-	if (!m_wellConfigured)
+	// check configuration, disabled values are not decoded
+	if (!m_wellConfigured || !this->getEnabled())
 	{
 		return;
 	}
@@ -530,14 +815,25 @@ void QUaModbusValue::setValue(
 	}
 	// convert to value
 	auto value = QUaModbusValue::blockToValue(block.mid(addressOffset, typeBlockSize), type);
+	// every sample is buffered, even if unchanged
+	this->collectSample(value, timestamp);
 	// avoid update or emit if no change, improves performance
 	auto oldValue = this->getValue();
 	if (oldValue == value && !forceIfSame)
 	{
+		// values read together share the timestamp, even if unchanged
+		if (timestamp.isValid())
+		{
+			this->value()->setSourceTimestamp(timestamp);
+		}
 		return;
 	}
 	// NOTE : set value before emitting to avoid recursion
 	this->value()->setValue(value);
+	if (timestamp.isValid())
+	{
+		this->value()->setSourceTimestamp(timestamp);
+	}
 	// emit
 	emit this->valueChanged(value);
 }
@@ -579,6 +875,9 @@ QDomElement QUaModbusValue::toDomElement(QDomDocument & domDoc) const
 	elemValue.setAttribute("BrowseName"   , this->browseName().name());
 	elemValue.setAttribute("Type"         , QMetaEnum::fromType<QModbusValueType>().valueToKey(this->getType()));
 	elemValue.setAttribute("AddressOffset", this->getAddressOffset());
+	elemValue.setAttribute("MinWriteInterval", this->getMinWriteInterval());
+	elemValue.setAttribute("BufferSize"      , this->getBufferSize());
+	elemValue.setAttribute("Enabled"         , this->getEnabled());
 #ifndef QUAMODBUS_NOCYCLIC_WRITE
 	elemValue.setAttribute("CyclicWriteMode"  , QMetaEnum::fromType<QModbusCyclicWriteMode>().valueToKey(this->getCyclicWriteMode()));
 	elemValue.setAttribute("CyclicWritePeriod", this->getCyclicWritePeriod());
@@ -636,6 +935,57 @@ void QUaModbusValue::fromDomElement(QDomElement & domElem, QQueue<QUaLog>& error
 			QUaLogCategory::Serialization
 		);
 	}
+	// MinWriteInterval (optional)
+	if (domElem.hasAttribute("MinWriteInterval"))
+	{
+		auto minWriteInterval = domElem.attribute("MinWriteInterval").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setMinWriteInterval(minWriteInterval);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid MinWriteInterval attribute '%1' in Value %2. Default value set.").arg(domElem.attribute("MinWriteInterval")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// BufferSize (optional)
+	if (domElem.hasAttribute("BufferSize"))
+	{
+		auto bufferSize = domElem.attribute("BufferSize").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setBufferSize(bufferSize);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid BufferSize attribute '%1' in Value %2. Default value set.").arg(domElem.attribute("BufferSize")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
+	// Enabled (optional)
+	if (domElem.hasAttribute("Enabled"))
+	{
+		auto enabled = (bool)domElem.attribute("Enabled").toUInt(&bOK);
+		if (bOK)
+		{
+			this->setEnabled(enabled);
+		}
+		else
+		{
+			errorLogs << QUaLog(
+				tr("Invalid Enabled attribute '%1' in Value %2. Default value set.").arg(domElem.attribute("Enabled")).arg(strBrowseName),
+				QUaLogLevel::Warning,
+				QUaLogCategory::Serialization
+			);
+		}
+	}
 #ifndef QUAMODBUS_NOCYCLIC_WRITE
 	// CyclicWriteMode
 	auto mode = (QModbusCyclicWriteMode)QMetaEnum::fromType<QModbusCyclicWriteMode>().keysToValue(domElem.attribute("CyclicWriteMode").toUtf8(), &bOK);
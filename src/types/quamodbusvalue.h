@@ -12,6 +12,9 @@
 
 #include <QDomDocument>
 #include <QDomElement>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QDateTime>
 
 class QUaModbusDataBlock;
 class QUaModbusValueList;
@@ -34,6 +37,9 @@ class QUaModbusValue : public QUaBaseObjectProtected
 	Q_PROPERTY(QUaProperty * Type              READ type             )
 	Q_PROPERTY(QUaProperty * RegistersUsed     READ registersUsed    )
 	Q_PROPERTY(QUaProperty * AddressOffset     READ addressOffset    )
+	Q_PROPERTY(QUaProperty * MinWriteInterval  READ minWriteInterval )
+	Q_PROPERTY(QUaProperty * BufferSize        READ bufferSize       )
+	Q_PROPERTY(QUaProperty * Enabled           READ enabled          )
 #ifndef QUAMODBUS_NOCYCLIC_WRITE
 	Q_PROPERTY(QUaProperty * CyclicWritePeriod READ cyclicWritePeriod)
 	Q_PROPERTY(QUaProperty * CyclicWriteMode   READ cyclicWriteMode  )
@@ -41,6 +47,9 @@ class QUaModbusValue : public QUaBaseObjectProtected
 	// UA variables
 	Q_PROPERTY(QUaBaseDataVariable * Value     READ value    )
 	Q_PROPERTY(QUaBaseDataVariable * LastError READ lastError)
+	Q_PROPERTY(QUaBaseDataVariable * DroppedWrites READ droppedWrites)
+	Q_PROPERTY(QUaBaseDataVariable * Buffer           READ buffer          )
+	Q_PROPERTY(QUaBaseDataVariable * BufferTimestamps READ bufferTimestamps)
 
 public:
 	Q_INVOKABLE explicit QUaModbusValue(QUaServer *server);
@@ -83,11 +92,17 @@ public:
 	QUaProperty * type();
 	QUaProperty * registersUsed();
 	QUaProperty * addressOffset();
+	QUaProperty * minWriteInterval();
+	QUaProperty * bufferSize();
+	QUaProperty * enabled();
 
 	// UA variables
 
 	QUaBaseDataVariable * value();
 	QUaBaseDataVariable * lastError();
+	QUaBaseDataVariable * droppedWrites();
+	QUaBaseDataVariable * buffer();
+	QUaBaseDataVariable * bufferTimestamps();
 
 	// UA methods
 
@@ -105,6 +120,25 @@ public:
 	QVariant getValue() const;
 	void     setValue(const QVariant &value);
 
+	// NOTE : writes closer in time than this (ms) are not sent, only the latest one is (0 disables)
+	quint32 getMinWriteInterval() const;
+	void    setMinWriteInterval(const quint32 &minWriteInterval);
+
+	// number of writes superseded by a more recent one before being sent
+	quint32 getDroppedWrites() const;
+
+	// NOTE : every sample read is also collected, and published all at once in Buffer and BufferTimestamps
+	//        when this many are collected, to cut notifications of high rate blocks (0 disables)
+	quint32 getBufferSize() const;
+	void    setBufferSize(const quint32 &bufferSize);
+
+	QVariantList getBuffer() const;
+	QVariantList getBufferTimestamps() const;
+
+	// NOTE : a disabled value is not decoded on reads nor written, but keeps its last value and config
+	bool getEnabled() const;
+	void setEnabled(const bool &enabled);
+
 #ifndef QUAMODBUS_NOCYCLIC_WRITE
 	enum CyclicWriteMode
 	{
@@ -149,6 +183,10 @@ signals:
 	void typeChanged         (const QModbusValueType &type         );
 	void registersUsedChanged(const quint16          &registersUsed);
 	void addressOffsetChanged(const int              &addressOffset);
+	void minWriteIntervalChanged(const quint32       &minWriteInterval);
+	void bufferSizeChanged   (const quint32          &bufferSize   );
+	void bufferChanged       (const QVariantList     &values, const QVariantList &timestamps);
+	void enabledChanged      (const bool             &enabled      );
 	void valueChanged        (const QVariant         &value        );
 	void lastErrorChanged    (const QModbusError     &error        );
 	// (internal) to safely update error in ua server thread
@@ -167,6 +205,11 @@ private slots:
 	void on_addressOffsetChanged    (const QVariant     &value, const bool& networkChange);
 	void on_valueChanged            (const QVariant     &value, const bool& networkChange);
 	void on_updateLastError         (const QModbusError &error);
+	void on_minWriteIntervalChanged (const QVariant     &value, const bool& networkChange);
+	void on_bufferSizeChanged       (const QVariant     &value, const bool& networkChange);
+	void on_enabledChanged          (const QVariant     &value, const bool& networkChange);
+	// send latest pending write
+	void on_writeThrottleTimeout();
 #ifndef QUAMODBUS_NOCYCLIC_WRITE
 	void on_cyclicWritePeriodChanged(const QVariant     &value, const bool& networkChange);
 	void on_cyclicWriteModeChanged  (const QVariant     &value, const bool& networkChange);
@@ -183,14 +226,32 @@ private:
 	QUaProperty* m_type;
 	QUaProperty* m_registersUsed;
 	QUaProperty* m_addressOffset;
+	QUaProperty* m_minWriteInterval;
 #ifndef QUAMODBUS_NOCYCLIC_WRITE
 	QUaProperty* m_cyclicWritePeriod;
 	QUaProperty* m_cyclicWriteMode;
 #endif // !QUAMODBUS_NOCYCLIC_WRITE
 	QUaBaseDataVariable* m_value;
 	QUaBaseDataVariable* m_lastError;
-
-	void setValue(const QVector<quint16> &block, const QModbusError &blockError, const bool forceIfSame = false);
+	QUaBaseDataVariable* m_droppedWrites;
+	QUaProperty*         m_bufferSize;
+	QUaProperty*         m_enabled;
+	QUaBaseDataVariable* m_buffer;
+	QUaBaseDataVariable* m_bufferTimestamps;
+	// samples collected until the buffer is full
+	QVariantList  m_bufferValues;
+	QVariantList  m_bufferTimes;
+	// write rate limit
+	quint32       m_droppedWritesCount;
+	QTimer        m_writeThrottle;
+	QElapsedTimer m_lastWrite;
+	QVariant      m_pendingWrite;
+
+	void write(const QVariant &value);
+
+	void collectSample(const QVariant &value, const QDateTime &timestamp);
+
+	void setValue(const QVector<quint16> &block, const QModbusError &blockError, const bool forceIfSame = false, const QDateTime &timestamp = QDateTime());
 
 	void updateWellConfigured(const QModbusValueType& type, const int& addressOffset);
 
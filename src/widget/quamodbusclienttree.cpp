@@ -1265,6 +1265,7 @@ void QUaModbusClientTree::showNewBlockDialog(QUaModbusClient* client, QUaModbusC
 	block->setAddress(widgetNewBlock->address());
 	block->setSize(widgetNewBlock->size());
 	block->setSamplingTime(widgetNewBlock->samplingTime());
+	block->setServerAddress(widgetNewBlock->serverAddress());
 	// NOTE : new block is added to tree using OPC UA events 
 }
 
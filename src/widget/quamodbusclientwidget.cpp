@@ -216,6 +216,21 @@ void QUaModbusClientWidget::bindClient(QUaModbusClient * client)
 		// clear
 		client->dataBlocks()->clear();
 	});
+	m_connections <<
+	QObject::connect(ui->pushButtonCapacity, &QPushButton::clicked, client,
+	[this, client]() {
+		Q_CHECK_PTR(client);
+		auto utilization = client->expectedUtilization();
+		QMessageBox msgBox(this);
+		msgBox.setWindowTitle(tr("Bus Capacity"));
+		msgBox.setIcon(utilization > 100.0 ? QMessageBox::Warning : QMessageBox::Information);
+		msgBox.setText(utilization > 100.0 ?
+			tr("Expected bus utilization is %1%.\nThe configured sampling times cannot be achieved.").arg(utilization, 0, 'f', 1) :
+			tr("Expected bus utilization is %1%.").arg(utilization, 0, 'f', 1)
+		);
+		msgBox.setDetailedText(client->capacityPlan());
+		msgBox.exec();
+	});
 	// NOTE : apply button bound in bindClientWidgetEdit
 }
 
@@ -446,5 +461,6 @@ void QUaModbusClientWidget::showNewBlockDialog(QUaModbusClient * client, QUaModb
 	block->setAddress(widgetNewBlock->address());
 	block->setSize(widgetNewBlock->size());
 	block->setSamplingTime(widgetNewBlock->samplingTime());
+	block->setServerAddress(widgetNewBlock->serverAddress());
 	// NOTE : new block is added to tree using OPC UA events 
 }
\ No newline at end of file
@@ -113,6 +113,7 @@ void QUaModbusDataBlockWidget::bindBlock(QUaModbusDataBlock * block)
 		ui->widgetBlockEdit->setAddressEditable     (canWrite);
 		ui->widgetBlockEdit->setSizeEditable        (canWrite);
 		ui->widgetBlockEdit->setSamplingTimeEditable(canWrite);
+		ui->widgetBlockEdit->setServerAddressEditable(canWrite);
 		// action buttons
 		ui->pushButtonApply   ->setEnabled(canWrite);
 		ui->pushButtonDelete  ->setEnabled(canWrite);
@@ -240,14 +241,22 @@ void QUaModbusDataBlockWidget::bindBlockWidgetEdit(QUaModbusDataBlock * block)
 	[this](const quint32 &samplingTime) {
 		ui->widgetBlockEdit->setSamplingTime(samplingTime);
 	});
+	// server address
+	ui->widgetBlockEdit->setServerAddress(block->getServerAddress());
+	m_connections <<
+	QObject::connect(block, &QUaModbusDataBlock::serverAddressChanged, ui->widgetBlockEdit,
+	[this](const int &serverAddress) {
+		ui->widgetBlockEdit->setServerAddress(serverAddress);
+	});
 	// on apply
 	m_connections <<
 	QObject::connect(ui->pushButtonApply, &QPushButton::clicked, ui->widgetBlockEdit,
 	[block, this]() {
-		block->setType        (ui->widgetBlockEdit->type());
-		block->setAddress     (ui->widgetBlockEdit->address());
-		block->setSize        (ui->widgetBlockEdit->size());
-		block->setSamplingTime(ui->widgetBlockEdit->samplingTime());
+		block->setType         (ui->widgetBlockEdit->type());
+		block->setAddress      (ui->widgetBlockEdit->address());
+		block->setSize         (ui->widgetBlockEdit->size());
+		block->setSamplingTime (ui->widgetBlockEdit->samplingTime());
+		block->setServerAddress(ui->widgetBlockEdit->serverAddress());
 	});
 }
 
@@ -25,6 +25,7 @@ QUaModbusDataBlockWidgetEdit::QUaModbusDataBlockWidgetEdit(QWidget *parent) :
 	this->setAddress(0);
 	this->setSize(10);
 	this->setSamplingTime(1000);
+	this->setServerAddress(-1);
 	// block wheel on widgets
 	auto comboBoxTypeEventHandler = new QUaWidgetEventFilter(ui->comboBoxType);
 	comboBoxTypeEventHandler->installEventCallback(QEvent::Wheel, blockWheel);
@@ -34,6 +35,8 @@ QUaModbusDataBlockWidgetEdit::QUaModbusDataBlockWidgetEdit(QWidget *parent) :
 	spinBoxSizeEventHandler->installEventCallback(QEvent::Wheel, blockWheel);
 	auto spinBoxSamplingEventHandler = new QUaWidgetEventFilter(ui->spinBoxSampling);
 	spinBoxSamplingEventHandler->installEventCallback(QEvent::Wheel, blockWheel);
+	auto spinBoxServerAddressEventHandler = new QUaWidgetEventFilter(ui->spinBoxServerAddress);
+	spinBoxServerAddressEventHandler->installEventCallback(QEvent::Wheel, blockWheel);
 }
 
 QUaModbusDataBlockWidgetEdit::~QUaModbusDataBlockWidgetEdit()
@@ -91,6 +94,16 @@ void QUaModbusDataBlockWidgetEdit::setSamplingTimeEditable(const bool & sampling
 	ui->spinBoxSampling->setReadOnly(!samplingTimeEditable);
 }
 
+bool QUaModbusDataBlockWidgetEdit::isServerAddressEditable() const
+{
+	return !ui->spinBoxServerAddress->isReadOnly();
+}
+
+void QUaModbusDataBlockWidgetEdit::setServerAddressEditable(const bool & serverAddressEditable)
+{
+	ui->spinBoxServerAddress->setReadOnly(!serverAddressEditable);
+}
+
 QString QUaModbusDataBlockWidgetEdit::id() const
 {
 	return ui->lineEditId->text();
@@ -142,3 +155,13 @@ void QUaModbusDataBlockWidgetEdit::setSamplingTime(const quint32 & samplingTime)
 {
 	ui->spinBoxSampling->setValue(samplingTime);
 }
+
+int QUaModbusDataBlockWidgetEdit::serverAddress() const
+{
+	return ui->spinBoxServerAddress->value();
+}
+
+void QUaModbusDataBlockWidgetEdit::setServerAddress(const int & serverAddress)
+{
+	ui->spinBoxServerAddress->setValue(serverAddress);
+}
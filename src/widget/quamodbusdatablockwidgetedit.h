@@ -31,6 +31,9 @@ public:
 
 	bool                 isSamplingTimeEditable() const;
 	void                 setSamplingTimeEditable(const bool &samplingTimeEditable);
+
+	bool                 isServerAddressEditable() const;
+	void                 setServerAddressEditable(const bool &serverAddressEditable);
 			             
 	QString              id() const;
 	void                 setId(const QString &strId);
@@ -47,6 +50,9 @@ public:
 	quint32              samplingTime() const;
 	void                 setSamplingTime(const quint32 &samplingTime);
 
+	int                  serverAddress() const;
+	void                 setServerAddress(const int &serverAddress);
+
 private:
     Ui::QUaModbusDataBlockWidgetEdit *ui;
 };